@@ -0,0 +1,343 @@
+#include <benchmark/benchmark.h>
+#include "pagesort.h"
+#include "textio.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+// Benchmarks de pagesort. Los tamaños van en bytes de enteros (4 bytes por número); por
+// omisión los algoritmos n log n llegan a 16 MB y los cuadráticos a 36 KB, como el archivo
+// más grande que viene con el proyecto. PAGESORT_BENCH_MAX_BYTES sube el límite de los
+// primeros (por ejemplo 4G), y los archivos de ejemplo se buscan en PAGESORT_DATA_DIR.
+
+enum Pattern { RANDOM, SORTED, REVERSE, DUPLICATES };
+
+const char* BENCH_FILE = "bench_input.bin";
+const char* BENCH_TEXT = "bench_input.txt";
+const char* BENCH_OUTPUT = "bench_output.txt";
+
+// Cuarto argumento de los benchmarks de ordenamiento: cómo PagedArray lee y escribe páginas
+enum Backend { STREAM, MMAP, ASYNC };
+const int BENCH_READ_AHEAD = 2;  // -r de ASYNC
+
+
+template <class Output>
+static void generate(Pattern pattern, long long count, Output& out) {
+    /**
+     * generate escribe en out la entrada de un benchmark con el patrón indicado, en bloques
+     * de TEXT_CHUNK bytes para que la entrada nunca esté entera en memoria; siempre con la
+     * misma semilla para que las corridas se puedan comparar.
+     *
+     * @param Pattern pattern, long long count, Output& out
+    */
+    std::vector<int> numbers(TEXT_CHUNK / sizeof(int));
+    unsigned int seed = 12345;
+    for (long long start = 0; start < count; start += numbers.size()) {
+        std::size_t len = static_cast<std::size_t>(
+            std::min<long long>(numbers.size(), count - start));
+        for (std::size_t k = 0; k < len; k++) {
+            long long i = start + k;
+            seed = seed * 1103515245 + 12345;
+            switch (pattern) {
+            case RANDOM:
+                numbers[k] = static_cast<int>(seed >> 1);
+                break;
+            case SORTED:
+                numbers[k] = static_cast<int>(i);
+                break;
+            case REVERSE:
+                numbers[k] = static_cast<int>(count - i);
+                break;
+            case DUPLICATES:
+                numbers[k] = static_cast<int>(seed >> 16) % 16;
+                break;
+            }
+        }
+        out.write(numbers.data(), len);
+    }
+}
+
+
+struct BinaryWriter {
+    // Misma interfaz que TextWriter, pero escribe los enteros tal cual
+    std::ofstream out;
+
+    explicit BinaryWriter(const std::string& filename)
+        : out(filename, std::ios::binary | std::ios::trunc) {}
+
+    void write(const int* numbers, std::size_t count) {
+        out.write(reinterpret_cast<const char*>(numbers), count * sizeof(int));
+    }
+};
+
+
+static void writeBinary(const std::string& filename, Pattern pattern, long long count) {
+    BinaryWriter out(filename);
+    generate(pattern, count, out);
+}
+
+
+static long long maxBytes() {
+    const char* value = std::getenv("PAGESORT_BENCH_MAX_BYTES");
+    long long bytes;
+    if (!value || !parseSize(value, bytes)) {
+        return 16LL << 20;
+    }
+    return bytes;
+}
+
+
+static void sortBenchmark(benchmark::State& state, const std::string& algorithm,
+                          Pattern pattern, int threads = 1) {
+    /**
+     * sortBenchmark ordena con sortBinaryFile un archivo binario generado. Los argumentos
+     * son bytes de entrada, marcos, bytes por página y backend (stream, mmap o stream con
+     * -r); escribir la entrada no se mide.
+     * Reporta elementos por segundo y bytes leídos y escritos por elemento; los fallos de
+     * página solo para los algoritmos que pasan por PagedArray (MS y RS no tienen).
+     *
+     * @param benchmark::State& state, String& algorithm, Pattern pattern, int threads
+    */
+    const long long count = state.range(0) / sizeof(int);
+
+    PagingStats stats;
+    PagingConfig config;
+    config.frames = static_cast<int>(state.range(1));
+    config.pageBytes = static_cast<int>(state.range(2));
+    config.threads = threads;
+    config.stats = &stats;
+    if (state.range(3) == MMAP) {
+        config.backend = "mmap";
+    } else if (state.range(3) == ASYNC) {
+        config.readAhead = BENCH_READ_AHEAD;
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        writeBinary(BENCH_FILE, pattern, count);
+        state.ResumeTiming();
+        sortBinaryFile(BENCH_FILE, algorithm, config);
+    }
+    std::remove(BENCH_FILE);
+
+    long long elements = count * state.iterations();
+    state.SetItemsProcessed(elements);
+    state.SetBytesProcessed(elements * sizeof(int));
+    state.counters["read/elem"] = elements ? static_cast<double>(stats.bytesRead) / elements : 0;
+    state.counters["written/elem"] =
+        elements ? static_cast<double>(stats.bytesWritten) / elements : 0;
+    if (algorithm != "MS" && algorithm != "RS") {
+        state.counters["faults/elem"] =
+            elements ? static_cast<double>(stats.misses) / elements : 0;
+        state.counters["dirty/fault"] =
+            stats.misses ? static_cast<double>(stats.dirtyEvictions) / stats.misses : 0;
+    }
+}
+
+
+static void backendArgs(benchmark::internal::Benchmark* bench, long long bytes, int frames,
+                        int pageBytes) {
+    // La misma entrada que una fila STREAM con los otros backends; mmap necesita páginas
+    // múltiplo de la del sistema. Solo para los algoritmos que pasan por PagedArray: a MS y
+    // RS el backend no los cambia
+    bench->Args({ bytes, frames, pageBytes, MMAP });
+    bench->Args({ bytes, frames, pageBytes, ASYNC });
+}
+
+
+static void fastSortArgs(benchmark::internal::Benchmark* bench) {
+    // Tamaño de entrada x marcos x bytes por página
+    bench->ArgNames({ "bytes", "frames", "page", "backend" })->Unit(benchmark::kMillisecond);
+    for (long long bytes = 1 << 10; bytes <= maxBytes(); bytes *= 16) {
+        bench->Args({ bytes, 6, 1 << 10, STREAM });
+    }
+    const int frames[] = { 3, 16, 64 };
+    const int pageBytes[] = { 1 << 10, 16 << 10 };
+    for (int f : frames) {
+        for (int p : pageBytes) {
+            bench->Args({ std::min(maxBytes(), 4LL << 20), f, p, STREAM });
+        }
+    }
+}
+
+
+static void pagedSortArgs(benchmark::internal::Benchmark* bench) {
+    // Como fastSortArgs, más la comparación entre backends
+    fastSortArgs(bench);
+    backendArgs(bench, std::min(maxBytes(), 4LL << 20), 16, 16 << 10);
+}
+
+
+static void slowSortArgs(benchmark::internal::Benchmark* bench) {
+    // Los cuadráticos solo con los tamaños de los archivos de ejemplo
+    bench->ArgNames({ "bytes", "frames", "page", "backend" })->Unit(benchmark::kMillisecond);
+    const int sizes[] = { 1 << 10, 4 << 10, 8 << 10, 12 << 10, 24 << 10, 36 << 10 };
+    for (int bytes : sizes) {
+        bench->Args({ bytes, 6, 1 << 10, STREAM });
+    }
+    bench->Args({ 8 << 10, 3, 256, STREAM });
+    bench->Args({ 8 << 10, 16, 256, STREAM });
+    bench->Args({ 36 << 10, 8, 4 << 10, STREAM });
+    backendArgs(bench, 36 << 10, 8, 4 << 10);
+}
+
+
+static void threadedSortArgs(benchmark::internal::Benchmark* bench) {
+    // -j 4: cada hilo recibe frames / 4 marcos
+    bench->ArgNames({ "bytes", "frames", "page", "backend" })->Unit(benchmark::kMillisecond);
+    bench->Args({ std::min(maxBytes(), 4LL << 20), 64, 16 << 10, STREAM });
+}
+
+
+static void threadedPagedSortArgs(benchmark::internal::Benchmark* bench) {
+    threadedSortArgs(bench);
+    backendArgs(bench, std::min(maxBytes(), 4LL << 20), 64, 16 << 10);
+}
+
+
+BENCHMARK_CAPTURE(sortBenchmark, QS/random, std::string("QS"), RANDOM)->Apply(pagedSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, QS/sorted, std::string("QS"), SORTED)->Apply(pagedSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, QS/reverse, std::string("QS"), REVERSE)->Apply(pagedSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, QS/duplicates, std::string("QS"), DUPLICATES)->Apply(pagedSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, MS/random, std::string("MS"), RANDOM)->Apply(fastSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, MS/sorted, std::string("MS"), SORTED)->Apply(fastSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, MS/reverse, std::string("MS"), REVERSE)->Apply(fastSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, MS/duplicates, std::string("MS"), DUPLICATES)->Apply(fastSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, RS/random, std::string("RS"), RANDOM)->Apply(fastSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, RS/sorted, std::string("RS"), SORTED)->Apply(fastSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, RS/duplicates, std::string("RS"), DUPLICATES)->Apply(fastSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, QS/random/j4, std::string("QS"), RANDOM, 4)
+    ->Apply(threadedPagedSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, MS/random/j4, std::string("MS"), RANDOM, 4)
+    ->Apply(threadedSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, IS/random, std::string("IS"), RANDOM)->Apply(slowSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, IS/sorted, std::string("IS"), SORTED)->Apply(slowSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, IS/reverse, std::string("IS"), REVERSE)->Apply(slowSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, SS/random, std::string("SS"), RANDOM)->Apply(slowSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, SS/duplicates, std::string("SS"), DUPLICATES)->Apply(slowSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, PS/random, std::string("PS"), RANDOM)->Apply(slowSortArgs);
+BENCHMARK_CAPTURE(sortBenchmark, PS/reverse, std::string("PS"), REVERSE)->Apply(slowSortArgs);
+
+
+static void policyBenchmark(benchmark::State& state, const std::string& policy) {
+    /**
+     * policyBenchmark compara las políticas de reemplazo con QS sobre la misma entrada
+     * aleatoria de 1 MB, con tan pocos marcos que casi cada partición falla.
+     *
+     * @param benchmark::State& state, String& policy
+    */
+    const long long count = (1 << 20) / sizeof(int);
+
+    PagingStats stats;
+    PagingConfig config;
+    config.frames = static_cast<int>(state.range(0));
+    config.policy = policy;
+    config.stats = &stats;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        writeBinary(BENCH_FILE, RANDOM, count);
+        state.ResumeTiming();
+        sortBinaryFile(BENCH_FILE, "QS", config);
+    }
+    std::remove(BENCH_FILE);
+
+    long long elements = count * state.iterations();
+    state.SetItemsProcessed(elements);
+    state.counters["faults/elem"] = static_cast<double>(stats.misses) / elements;
+    state.counters["written/elem"] = static_cast<double>(stats.bytesWritten) / elements;
+}
+
+
+BENCHMARK_CAPTURE(policyBenchmark, LRU, std::string("LRU"))->Arg(4)->Arg(32)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(policyBenchmark, CLOCK, std::string("CLOCK"))->Arg(4)->Arg(32)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(policyBenchmark, LFU, std::string("LFU"))->Arg(4)->Arg(32)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(policyBenchmark, ARC, std::string("ARC"))->Arg(4)->Arg(32)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(policyBenchmark, 2Q, std::string("2Q"))->Arg(4)->Arg(32)
+    ->Unit(benchmark::kMillisecond);
+
+
+static void writeText(const std::string& filename, long long bytes) {
+    // Texto de ~bytes bytes con números aleatorios de todos los largos
+    TextWriter out(filename);
+    generate(RANDOM, bytes / 11 + 1, out);
+}
+
+
+static void convertToBinaryBenchmark(benchmark::State& state) {
+    // MB/s de texto leído
+    writeText(BENCH_TEXT, state.range(0));
+    for (auto _ : state) {
+        convertToBinary(BENCH_TEXT, BENCH_FILE);
+    }
+    state.SetBytesProcessed(fileBytes(BENCH_TEXT) * state.iterations());
+    std::remove(BENCH_TEXT);
+    std::remove(BENCH_FILE);
+}
+
+
+static void convertToTextBenchmark(benchmark::State& state) {
+    // MB/s de texto escrito
+    writeText(BENCH_TEXT, state.range(0));
+    convertToBinary(BENCH_TEXT, BENCH_FILE);
+    for (auto _ : state) {
+        convertToText(BENCH_FILE, BENCH_OUTPUT);
+    }
+    state.SetBytesProcessed(fileBytes(BENCH_OUTPUT) * state.iterations());
+    std::remove(BENCH_TEXT);
+    std::remove(BENCH_FILE);
+    std::remove(BENCH_OUTPUT);
+}
+
+
+BENCHMARK(convertToBinaryBenchmark)->Arg(1 << 20)->Arg(64 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(convertToTextBenchmark)->Arg(1 << 20)->Arg(64 << 20)->Unit(benchmark::kMillisecond);
+
+
+static void bundledFileBenchmark(benchmark::State& state, const std::string& algorithm) {
+    /**
+     * bundledFileBenchmark corre el camino completo de main (texto a texto) sobre uno de los
+     * archivos de ejemplo del proyecto; el argumento es su tamaño en KB.
+     *
+     * @param benchmark::State& state, String& algorithm
+    */
+    std::string input = std::string(PAGESORT_DATA_DIR) + "/" +
+                        std::to_string(state.range(0)) + "KB.txt";
+    if (!std::ifstream(input).good()) {
+        state.SkipWithError(("No se encontró " + input).c_str());
+        return;
+    }
+    for (auto _ : state) {
+        sortTextFile(input, BENCH_OUTPUT, BENCH_FILE, algorithm);
+    }
+    state.SetBytesProcessed(fileBytes(input) * state.iterations());
+    std::remove(BENCH_OUTPUT);
+}
+
+
+static void bundledArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("KB")->Unit(benchmark::kMillisecond);
+    const int sizes[] = { 1, 4, 8, 12, 24, 36 };
+    for (int kb : sizes) {
+        bench->Arg(kb);
+    }
+}
+
+
+BENCHMARK_CAPTURE(bundledFileBenchmark, QS, std::string("QS"))->Apply(bundledArgs);
+BENCHMARK_CAPTURE(bundledFileBenchmark, MS, std::string("MS"))->Apply(bundledArgs);
+BENCHMARK_CAPTURE(bundledFileBenchmark, RS, std::string("RS"))->Apply(bundledArgs);
+BENCHMARK_CAPTURE(bundledFileBenchmark, IS, std::string("IS"))->Apply(bundledArgs);
+BENCHMARK_CAPTURE(bundledFileBenchmark, SS, std::string("SS"))->Apply(bundledArgs);
+BENCHMARK_CAPTURE(bundledFileBenchmark, PS, std::string("PS"))->Apply(bundledArgs);
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,210 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <cstdio> // para std::remove
+#include "pagesort.h"
+#include "pagestore.h"
+#include "replacement.h"
+
+
+static bool parseCount(const std::string& text, long long& value) {
+    /**
+     * parseCount interpreta una cantidad: solo dígitos, sin signo ni sufijos de tamaño.
+     *
+     * @param String& text, long long& value
+     * @return false si el texto no es un entero no negativo
+    */
+    if (text.empty() || text.size() > 18 ||
+        text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    value = std::stoll(text);
+    return true;
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc % 2 == 0) {
+        std::cerr << "Uso incorrecto. La sintaxis correcta es:\n";
+        std::cerr << "paged-sort -i <archivo> -a {QS|IS|SS|PS|MS|RS} -o <archivo_resultado>"
+                  << " [-p {LRU|CLOCK|LFU|ARC|2Q}] [-s <bytes_por_página>]"
+                  << " [-f <marcos> | -m <bytes_de_memoria>] [-b {stream|mmap}]"
+                  << " [-r <páginas_adelantadas>] [-j <hilos>] [--stats {text|json}]"
+                  << " [--trace <archivo_de_traza>]"
+                  << " [-t {i32|i64|u64|f64|rec:<bytes>:<offset_clave>[:<tipo_clave>]}]\n";
+        std::cerr << "paged-sort --replay <archivo_de_traza> [-a ...] [-p ...] [-s ...]"
+                  << " [-f ... | -m ...] [-b ...] [-r ...] [-t ...] [--stats {text|json}]\n";
+        std::cerr << "Con -t rec los archivos de entrada y salida son binarios.\n";
+        return EXIT_FAILURE;
+    }
+
+    std::string inputFile, outputFile, algorithm, replayFile;
+    PagingConfig config;
+    long long pageBytes = PAGE_BYTES;
+    long long memoryBytes = 0;
+    long long frames = PAGE_FRAMES;
+    std::string statsFormat;
+    PagingStats stats;
+
+    for (int i = 1; i < argc; i += 2) {
+        if (std::string(argv[i]) == "-i") {
+            inputFile = argv[i + 1];
+        } else if (std::string(argv[i]) == "-o") {
+            outputFile = argv[i + 1];
+        } else if (std::string(argv[i]) == "-a") {
+            algorithm = argv[i + 1];
+        } else if (std::string(argv[i]) == "-p") {
+            config.policy = argv[i + 1];
+        } else if (std::string(argv[i]) == "-b") {
+            config.backend = argv[i + 1];
+        } else if (std::string(argv[i]) == "-r") {
+            long long pages = 0;
+            if (!parseCount(argv[i + 1], pages) || pages > 1 << 20) {
+                std::cerr << "Cantidad de páginas adelantadas inválida: " << argv[i + 1] << "\n";
+                return EXIT_FAILURE;
+            }
+            config.readAhead = static_cast<int>(pages);
+        } else if (std::string(argv[i]) == "--stats") {
+            statsFormat = argv[i + 1];
+            if (statsFormat != "text" && statsFormat != "json") {
+                std::cerr << "Formato de estadísticas no reconocido: " << statsFormat << "\n";
+                return EXIT_FAILURE;
+            }
+            config.stats = &stats;
+        } else if (std::string(argv[i]) == "--trace") {
+            config.trace = argv[i + 1];
+        } else if (std::string(argv[i]) == "--replay") {
+            replayFile = argv[i + 1];
+        } else if (std::string(argv[i]) == "-j") {
+            long long threads = 0;
+            if (!parseCount(argv[i + 1], threads) || threads < 1 || threads > 1024) {
+                std::cerr << "Cantidad de hilos inválida: " << argv[i + 1] << "\n";
+                return EXIT_FAILURE;
+            }
+            config.threads = static_cast<int>(threads);
+        } else if (std::string(argv[i]) == "-t") {
+            if (!parseElementType(argv[i + 1], config.element)) {
+                std::cerr << "Tipo de elemento inválido: " << argv[i + 1] << "\n";
+                return EXIT_FAILURE;
+            }
+        } else if (std::string(argv[i]) == "-s") {
+            if (!parseSize(argv[i + 1], pageBytes)) {
+                std::cerr << "Tamaño de página inválido: " << argv[i + 1] << "\n";
+                return EXIT_FAILURE;
+            }
+        } else if (std::string(argv[i]) == "-f") {
+            if (!parseCount(argv[i + 1], frames)) {
+                std::cerr << "Cantidad de marcos inválida: " << argv[i + 1] << "\n";
+                return EXIT_FAILURE;
+            }
+        } else if (std::string(argv[i]) == "-m") {
+            if (!parseSize(argv[i + 1], memoryBytes)) {
+                std::cerr << "Memoria inválida: " << argv[i + 1] << "\n";
+                return EXIT_FAILURE;
+            }
+        } else {
+            std::cerr << "Argumento no reconocido: " << argv[i] << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (replayFile.empty() && (inputFile.empty() || outputFile.empty() || algorithm.empty())) {
+        std::cerr << "Error en los argumentos proporcionados.\n";
+        return EXIT_FAILURE;
+    }
+
+    if (!makeReplacementPolicy(config.policy, 1)) {
+        std::cerr << "Política de reemplazo no reconocida: " << config.policy << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (config.backend != "stream" && config.backend != "mmap") {
+        std::cerr << "Backend no reconocido: " << config.backend << "\n";
+        return EXIT_FAILURE;
+    }
+
+    // mmap mapea y suelta memoria de a páginas del sistema: con páginas más chicas cada marco
+    // ocuparía una página del sistema entera y el presupuesto de memoria no se cumpliría
+    const long long systemPage = systemPageBytes();
+    if (config.backend == "mmap" && pageBytes % systemPage != 0) {
+        pageBytes = (pageBytes + systemPage - 1) / systemPage * systemPage;
+        std::cerr << "Con -b mmap el tamaño de página se redondea a " << pageBytes
+                  << " bytes, múltiplo de la página del sistema.\n";
+    }
+
+    // Con -m la cantidad de marcos sale de la memoria disponible
+    if (memoryBytes > 0) {
+        frames = memoryBytes / pageBytes;
+    }
+    if (pageBytes > 1 << 30 || frames > 1 << 30) {
+        std::cerr << "El tamaño de página y la cantidad de marcos no pueden pasar de 2^30.\n";
+        return EXIT_FAILURE;
+    }
+    // Las páginas tienen que llevar elementos enteros; los registros se paginan como etiquetas
+    if (config.element.kind != ElementType::REC && pageBytes % config.element.size != 0) {
+        std::cerr << "El tamaño de página tiene que ser múltiplo de " << config.element.size
+                  << " bytes.\n";
+        return EXIT_FAILURE;
+    }
+    if (frames < 3) {
+        std::cerr << "Se necesitan al menos 3 marcos de página dentro de la memoria indicada.\n";
+        return EXIT_FAILURE;
+    }
+    config.pageBytes = static_cast<int>(pageBytes);
+    config.frames = static_cast<int>(frames);
+    // QS necesita un marco más: los bloques de partition también salen del presupuesto
+    const int needed = sortFrames(algorithm);
+    if (config.frames - ioFrames(config) < needed) {
+        std::cerr << "Con -r " << config.readAhead << " se reservan " << ioFrames(config)
+                  << " marcos para E/S; no quedan al menos " << needed << " para ordenar.\n";
+        return EXIT_FAILURE;
+    }
+    // Los marcos se reparten entre los hilos: la memoria total no cambia
+    if (config.frames / config.threads - ioFrames(config) < needed) {
+        std::cerr << "Con " << config.frames << " marcos no alcanzan para " << config.threads
+                  << " hilos; cada uno necesita al menos " << ioFrames(config) + needed << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    // --replay no ordena nada: pasa la traza por la configuración indicada y muestra lo que
+    // habría contado PagedArray. Con -a QS el arreglo tuvo PARTITION_FRAMES marcos menos
+    if (!replayFile.empty()) {
+        if (!std::ifstream(replayFile).good()) {
+            std::cerr << "No se pudo abrir la traza: " << replayFile << "\n";
+            return EXIT_FAILURE;
+        }
+        if (algorithm == "QS") {
+            config.frames -= PARTITION_FRAMES;
+        }
+        printStats(std::cout, replayTrace(replayFile, config),
+                   statsFormat.empty() ? "text" : statsFormat);
+        return 0;
+    }
+
+    // MS y RS no pasan por PagedArray, así que no anotan ningún acceso
+    if (!config.trace.empty() && (algorithm == "MS" || algorithm == "RS")) {
+        std::cerr << "Aviso: --trace no tiene efecto con -a " << algorithm
+                  << "; no se escribirá " << config.trace << ".\n";
+    }
+
+    std::string binaryFile = "temp_binary_file.bin";
+
+    // Algoritmos de ordenamiento...
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (!sortTextFile(inputFile, outputFile, binaryFile, algorithm, config)) {
+        std::cerr << "Algoritmo no reconocido: " << algorithm << "\n";
+        return EXIT_FAILURE;
+    }
+    stats.totalSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+
+    std::cout << "Archivo " << inputFile << " ordenado usando " << algorithm 
+              << " (" << config.policy << ") y guardado en " << outputFile << ".\n";
+    if (!statsFormat.empty()) {
+        printStats(std::cout, stats, statsFormat);
+    }
+
+    return 0;
+}
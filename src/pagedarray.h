@@ -0,0 +1,410 @@
+#ifndef PAGEDARRAY_H
+#define PAGEDARRAY_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "pagesort.h"
+#include "pagestore.h"
+#include "replacement.h"
+
+
+template <int PageSize>
+struct PageGeometry {
+    /*PageGeometry con el tamaño de página fijo en compilación: para potencias de dos el
+     * compilador convierte la división y el módulo en un corrimiento y una máscara.
+    */
+    explicit PageGeometry(int) {}
+    int size() const { return PageSize; }
+    long long page(long long index) const {
+        return static_cast<unsigned long long>(index) / PageSize;
+    }
+    int offset(long long index) const {
+        return static_cast<int>(static_cast<unsigned long long>(index) % PageSize);
+    }
+};
+
+template <>
+struct PageGeometry<0> {
+    /*PageGeometry para tamaños de página que solo se conocen en tiempo de ejecución*/
+    int pageSize;
+    explicit PageGeometry(int pageSize) : pageSize(pageSize) {}
+    int size() const { return pageSize; }
+    long long page(long long index) const { return index / pageSize; }
+    int offset(long long index) const { return static_cast<int>(index % pageSize); }
+};
+
+
+class PageTable {
+    /*PageTable traduce números de página a marcos con una tabla hash de direccionamiento
+     * abierto (sondeo lineal). Tiene al menos el doble de casillas que marcos, así que ocupa
+     * memoria proporcional a los marcos y no al tamaño del archivo.
+    */
+    std::vector<long long> keys;  // página guardada en cada casilla, -1 si está libre
+    std::vector<int> values;      // marco de esa página
+    unsigned int mask;
+    int shift;
+
+    unsigned int slot(long long page) const {
+        // Hash multiplicativo de Fibonacci: usa los bits altos del producto
+        return static_cast<unsigned int>(
+            (static_cast<unsigned long long>(page) * 11400714819323198485ull) >> shift);
+    }
+
+public:
+    explicit PageTable(int frames) {
+        int bits = 1;
+        while ((1 << bits) < 2 * frames) {
+            bits++;
+        }
+        keys.assign(1 << bits, -1);
+        values.assign(1 << bits, -1);
+        mask = (1u << bits) - 1;
+        shift = 64 - bits;
+    }
+
+    int find(long long page) const {
+        for (unsigned int i = slot(page); keys[i] != -1; i = (i + 1) & mask) {
+            if (keys[i] == page) {
+                return values[i];
+            }
+        }
+        return -1;
+    }
+
+    void insert(long long page, int frame) {
+        unsigned int i = slot(page);
+        while (keys[i] != -1) {
+            i = (i + 1) & mask;
+        }
+        keys[i] = page;
+        values[i] = frame;
+    }
+
+    void erase(long long page) {
+        unsigned int i = slot(page);
+        while (keys[i] != page) {
+            i = (i + 1) & mask;
+        }
+        // Borrado hacia atrás: recorrer el grupo y mover las entradas que quedarían
+        // inalcanzables, así no hacen falta lápidas
+        for (unsigned int j = (i + 1) & mask; keys[j] != -1; j = (j + 1) & mask) {
+            unsigned int home = slot(keys[j]);
+            if (((j - home) & mask) >= ((j - i) & mask)) {
+                keys[i] = keys[j];
+                values[i] = values[j];
+                i = j;
+            }
+        }
+        keys[i] = -1;
+    }
+};
+
+
+inline double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void addFaultHistogram(PagingStats& stats,
+                       const std::unordered_map<long long, long long>& pageFaults,
+                       long long pages);
+void addPagingStats(PagingStats& report, const PagingStats& stats);
+
+
+template <class T>
+inline int pageElements(const PagingConfig& config) {
+    // Elementos de T que caben en una página de config.pageBytes bytes (al menos uno)
+    return std::max(1, static_cast<int>(config.pageBytes / sizeof(T)));
+}
+
+
+template <class T, int PageSize = 0>
+class PagedArray {
+    /*Paged Array es la clase encargada de la manipulación de las páginas a utilizar o utilizadas
+     * 
+     * T es el tipo de los elementos. PageSize fija en compilación la cantidad de elementos
+     * por página; con 0 se calcula en tiempo de ejecución con PagingConfig::pageBytes.
+     *
+     * Puede cubrir solo un rango del archivo (count elementos a partir de first); los índices
+     * empiezan en 0 al inicio del rango. Cada PagedArray tiene su propio PageStore, así que
+     * varios hilos pueden ordenar rangos distintos del mismo archivo a la vez.
+    */
+
+
+    PageGeometry<PageSize> geometry;
+    int frames;
+    std::vector<T*> pages;//establece la cantidad de páginas que se utilizaran
+    std::vector<long long> loadedPages;
+    std::vector<bool> dirtyPages;  // Almacena si una página ha sido modificada
+    std::unique_ptr<PageStore> store;  // fstream o mmap, según PagingConfig::backend
+
+    std::unique_ptr<ReplacementPolicy> policy;  // decide qué página sale cuando no hay marcos libres
+    PageTable pageTable;  // página -> marco en O(1)
+    int usedFrames = 0;
+
+    // Instrumentación: los contadores se llevan siempre; los tiempos, el histograma y la
+    // traza solo si se pidieron en PagingConfig
+    PagingStats stats;
+    PagingStats* report = nullptr;  // dónde sumar stats al destruir el arreglo
+    // Fallos de cada página que falló: crece con las páginas tocadas y no con el archivo
+    std::unordered_map<long long, long long> pageFaults;
+    std::unique_ptr<std::ofstream> trace;
+
+    long long pageBytes(long long page) const {
+        // La última página puede quedar incompleta
+        long long rest = size() - page * geometry.size();
+        return std::min<long long>(geometry.size(), rest) * sizeof(T);
+    }
+
+    void traceAccess(char operation, long long index) {
+        // Fuera de read y write para que la traza no les impida quedar en línea
+        *trace << operation << ' ' << index << '\n';
+    }
+
+    void savePageToDisk(int pageIndex) {
+        if (dirtyPages[pageIndex]) {
+            std::chrono::steady_clock::time_point start;
+            if (report) {
+                start = std::chrono::steady_clock::now();
+            }
+            store->save(loadedPages[pageIndex], pageIndex);
+            dirtyPages[pageIndex] = false;
+            stats.bytesWritten += pageBytes(loadedPages[pageIndex]);
+            if (report) {
+                stats.saveSeconds += secondsSince(start);
+            }
+        }
+    }
+
+    // Última página usada: en recorridos secuenciales casi todos los accesos caen aquí
+    long long lastPage = -1;
+    int lastFrame = -1;
+
+    int frameOf(long long page) {
+        /**
+         * frameOf busca el marco donde está la página y la carga si no está en memoria.
+         *
+         * @param long long page
+         * @return el marco que tiene la página
+        */
+        stats.accesses++;
+        if (page == lastPage) {
+            // La política ya vio este marco en el acceso anterior
+            return lastFrame;
+        }
+
+        int frame = pageTable.find(page);
+        if (frame != -1) {
+            policy->accessed(frame);
+            lastPage = page;
+            lastFrame = frame;
+            return frame;
+        }
+
+        std::chrono::steady_clock::time_point start;
+        if (report) {
+            start = std::chrono::steady_clock::now();
+            pageFaults[page]++;
+        }
+        stats.misses++;
+
+        // Usar un marco libre si queda alguno; si no, la política escoge la víctima
+        int replacePage = usedFrames < frames ? usedFrames++ : policy->victim(page);
+        
+        // Sacar la página del marco; si está "sucia" el store la guarda en disco
+        if (loadedPages[replacePage] != -1) {
+            if (dirtyPages[replacePage]) {
+                stats.dirtyEvictions++;
+                stats.bytesWritten += pageBytes(loadedPages[replacePage]);
+            } else {
+                stats.cleanEvictions++;
+            }
+            store->evict(loadedPages[replacePage], replacePage, dirtyPages[replacePage]);
+            dirtyPages[replacePage] = false;
+            pageTable.erase(loadedPages[replacePage]);
+        }
+
+        // Cargar la nueva página en memoria
+        loadedPages[replacePage] = page;
+        pageTable.insert(page, replacePage);
+        policy->loaded(replacePage, page);
+        lastPage = page;
+        lastFrame = replacePage;
+
+        pages[replacePage] = reinterpret_cast<T*>(store->load(page, replacePage));
+        stats.bytesRead += pageBytes(page);
+        if (report) {
+            stats.loadSeconds += secondsSince(start);
+        }
+
+        return replacePage;
+    }
+
+public:
+    PagedArray(const std::string& filename, const PagingConfig& config,
+               long long first = 0, long long count = -1)
+        : geometry(pageElements<T>(config)), frames(config.frames - ioFrames(config)),
+          pages(frames, nullptr), loadedPages(frames, -1), dirtyPages(frames, false),
+          pageTable(frames) {
+        policy = makeReplacementPolicy(config.policy, frames);
+        if (!policy) {
+            std::cerr << "Política de reemplazo no reconocida: " << config.policy << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        store = makePageStore(config.backend, filename, sizeof(T), geometry.size(), frames,
+                              config.readAhead, first, count);
+        if (!store) {
+            std::cerr << "Backend no reconocido: " << config.backend << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        if (!store->isOpen()) {
+            std::cerr << "No se pudo abrir el archivo: " << filename << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        if (config.stats) {
+            report = config.stats;
+        }
+        if (!config.trace.empty()) {
+            trace.reset(new std::ofstream(config.trace, std::ios::trunc));
+        }
+    }
+
+    typedef T value_type;
+
+    long long size() const {
+        return store->elements();
+    }
+
+    int pageSize() const {
+        return geometry.size();
+    }
+
+    ~PagedArray() {
+        // Antes de cerrar, asegurarse de guardar cualquier página modificada
+        for (int i = 0; i < frames; i++) {
+            savePageToDisk(i);
+        }
+        if (report) {
+            stats.hits = stats.accesses - stats.misses;
+            addFaultHistogram(stats, pageFaults, (size() + geometry.size() - 1) / geometry.size());
+            addPagingStats(*report, stats);
+        }
+    }
+
+    class Reference {
+        /*Reference es lo que devuelve operator[]: leerla pasa por read y asignarle un valor
+         * pasa por write, así ningún algoritmo tiene que marcar las páginas a mano.
+        */
+        PagedArray* array;
+        long long index;
+
+    public:
+        Reference(PagedArray* array, long long index) : array(array), index(index) {}
+
+        operator T() const {
+            return array->read(index);
+        }
+
+        Reference& operator=(T value) {
+            // Por valor: value puede apuntar a un marco que write va a reemplazar
+            array->write(index, value);
+            return *this;
+        }
+
+        Reference& operator=(const Reference& other) {
+            // Leer primero: cargar la otra página puede sacar de memoria la de este elemento
+            return *this = static_cast<T>(other);
+        }
+    };
+
+    Reference operator[](long long index) {
+        return Reference(this, index);
+    }
+
+    T read(long long index) {
+        if (trace) {
+            traceAccess('R', index);
+        }
+        return pages[frameOf(geometry.page(index))][geometry.offset(index)];
+    }
+
+    void write(long long index, T value) {
+        /**
+         * write guarda value en la posición index y marca la página como sucia solo si el
+         * valor realmente cambió, para no escribir en disco páginas que siguen iguales. Se
+         * comparan los bytes y no los valores: 0.0 == -0.0 y un NaN nunca es igual a sí mismo.
+         * value va por copia porque quien llama puede pasar un elemento de otro marco, y el
+         * fallo de página de index puede reemplazar ese marco antes de leerlo.
+         *
+         * @param long long index, T value
+        */
+        int frame = frameOf(geometry.page(index));
+        T& slot = pages[frame][geometry.offset(index)];
+        bool changed = std::memcmp(&slot, &value, sizeof(T)) != 0;
+        if (changed) {
+            slot = value;
+            dirtyPages[frame] = true;
+        }
+        if (trace) {
+            // Una escritura que no cambia nada cuenta como lectura: no ensucia la página
+            traceAccess(changed ? 'W' : 'R', index);
+        }
+    }
+
+    T* span(long long index, long long& first, int& count, bool modify) {
+        /**
+         * span da acceso directo a la página donde está index, para que los ciclos internos
+         * de los algoritmos recorran elementos contiguos sin pasar por frameOf en cada uno. El
+         * puntero solo vale hasta el siguiente acceso al arreglo, que puede sacar la página
+         * del marco. Con modify la página queda sucia; para las estadísticas y la traza
+         * cuenta como un solo acceso a index.
+         *
+         * @param long long index, long long& first, int& count, bool modify
+         * @return los elementos de la página; first es el índice del primero y count cuántos hay
+        */
+        long long page = geometry.page(index);
+        int frame = frameOf(page);
+        if (modify) {
+            dirtyPages[frame] = true;
+        }
+        if (trace) {
+            traceAccess(modify ? 'W' : 'R', index);
+        }
+        first = page * geometry.size();
+        count = static_cast<int>(std::min<long long>(geometry.size(), size() - first));
+        return pages[frame];
+    }
+
+    void swap(long long a, long long b) {
+        /**
+         * swap intercambia dos elementos por valor; std::swap no sirve porque operator[]
+         * devuelve una Reference temporal y no un T&.
+         *
+         * @param long long a, long long b
+         * @return los dos elementos intercambiados
+        */
+        T valueA = read(a);
+        T valueB = read(b);
+        write(a, valueB);
+        write(b, valueA);
+    }
+
+    void writeToFile() {
+        /**
+         * writeToFile guarda en el archivo las páginas modificadas que siguen en memoria; las
+         * que ya salieron se guardaron al ser reemplazadas.
+        */
+        for (int i = 0; i < frames; i++) {
+            savePageToDisk(i);
+        }
+    }
+};
+
+#endif
@@ -4,229 +4,642 @@
 #include <algorithm>
 #include <iterator>
 #include <sstream>
-#include <cstring> // para std::remove
+#include <cstring> // para std::remove y std::memcmp
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include "pagesort.h"
+#include "pagedarray.h"
+#include "replacement.h"
+#include "pagestore.h"
+#include "textio.h"
 
 
-const int PAGE_SIZE = 256;
 
 
-class PagedArray {
-    /*Paged Array es la clase encargada de la manipulación de las páginas a utilizar o utilizadas
-     * 
-     * 
-     * 
-    */
+// Protege el PagingStats compartido cuando varios hilos suman sus contadores
+static std::mutex statsMutex;
 
 
-    std::vector<int> pages[6];//establece la cantidad de páginas que se utilizaran
-    int loadedPages[6];
-    bool dirtyPages[6] = {false};  // Almacena si una página ha sido modificada
-    std::fstream file;
+static void addPageFaults(PagingStats& stats, long long faults, long long pages = 1) {
+    // Suma pages páginas con faults fallos cada una a la casilla que les toca del histograma
+    int bucket = 0;
+    while (faults >> bucket) {
+        bucket++;
+    }
+    if (bucket >= static_cast<int>(stats.faultHistogram.size())) {
+        stats.faultHistogram.resize(bucket + 1, 0);
+    }
+    stats.faultHistogram[bucket] += pages;
+}
 
-    unsigned long long accessCounter = 0;
-    unsigned long long lastAccessed[6] = {0};
 
-    int findLRUPage() {
-        int oldestPage = 0;
-        for (int i = 1; i < 6; i++) {
-            if (lastAccessed[i] < lastAccessed[oldestPage]) {
-                oldestPage = i;
-            }
-        }
-        return oldestPage;
+void addFaultHistogram(PagingStats& stats,
+                       const std::unordered_map<long long, long long>& pageFaults,
+                       long long pages) {
+    /**
+     * addFaultHistogram agrega al histograma de stats la cantidad de fallos de cada página.
+     * pageFaults solo tiene las páginas que fallaron; las demás hasta pages van a la casilla
+     * 0.
+     *
+     * @param PagingStats& stats, unordered_map<long long, long long>& pageFaults,
+     * long long pages
+    */
+    for (const std::pair<const long long, long long>& faults : pageFaults) {
+        addPageFaults(stats, faults.second);
+    }
+    if (pages > static_cast<long long>(pageFaults.size())) {
+        addPageFaults(stats, 0, pages - pageFaults.size());
     }
+}
 
-    void savePageToDisk(int pageIndex) {
-        if (dirtyPages[pageIndex]) {
-            file.seekp(loadedPages[pageIndex] * PAGE_SIZE * sizeof(int), file.beg);
-            file.write(reinterpret_cast<char*>(pages[pageIndex].data()), PAGE_SIZE * sizeof(int));
-            dirtyPages[pageIndex] = false;
-        }
+
+void addPagingStats(PagingStats& report, const PagingStats& stats) {
+    // Suma stats a report; varios hilos pueden llegar a la vez
+    std::lock_guard<std::mutex> guard(statsMutex);
+    report.add(stats);
+}
+
+
+template <class Key>
+struct Tagged {
+    /*Tagged es lo que se ordena en lugar de un registro (-t rec): su clave y su posición en
+     * el archivo. Las etiquetas ocupan 16 bytes sin importar el tamaño del registro y al
+     * desempatar por posición los registros con la misma clave quedan en el orden original.
+    */
+    Key key;
+    unsigned long long index;
+};
+
+
+template <class T>
+struct ElementOrder {
+    /*ElementOrder<T> es el orden de cada tipo de elemento y el comparador que reciben los
+     * algoritmos: operator() es el menor que, y radixKey lleva cada elemento a un entero sin
+     * signo con el mismo orden para el radix sort. Cada especialización queda en línea
+     * dentro de los ciclos internos.
+    */
+};
+
+template <>
+struct ElementOrder<int> {
+    typedef unsigned int Key;
+    bool operator()(int a, int b) const { return a < b; }
+    // Con el bit de signo invertido los negativos quedan antes que los positivos
+    static Key radixKey(int value) { return static_cast<unsigned int>(value) ^ 0x80000000u; }
+};
+
+template <>
+struct ElementOrder<long long> {
+    typedef unsigned long long Key;
+    bool operator()(long long a, long long b) const { return a < b; }
+    static Key radixKey(long long value) {
+        return static_cast<unsigned long long>(value) ^ (1ull << 63);
     }
+};
 
-public:
-    PagedArray(const std::string& filename) {
-        for (int i = 0; i < 6; i++) {
-            loadedPages[i] = -1;
-            pages[i].resize(PAGE_SIZE, 0);
-        }
-        file.open(filename, std::ios::in | std::ios::out | std::ios::binary);
-        if (!file.is_open()) {
-            std::cerr << "No se pudo abrir el archivo: " << filename << std::endl;
-            exit(EXIT_FAILURE);
+template <>
+struct ElementOrder<unsigned long long> {
+    typedef unsigned long long Key;
+    bool operator()(unsigned long long a, unsigned long long b) const { return a < b; }
+    static Key radixKey(unsigned long long value) { return value; }
+};
+
+template <>
+struct ElementOrder<double> {
+    // Los NaN van todos al final: con < solo, un NaN rompería el orden que espera std::sort
+    typedef unsigned long long Key;
+    bool operator()(double a, double b) const { return a < b || (b != b && a == a); }
+    static Key radixKey(double value) {
+        if (value != value) {
+            return ~0ull;
         }
+        // Positivos: prender el bit de signo; negativos: invertir todo, así el orden se da vuelta
+        unsigned long long bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits >> 63 ? ~bits : bits | (1ull << 63);
     }
+};
 
-    ~PagedArray() {
-        // Antes de cerrar, asegurarse de guardar cualquier página modificada
-        for (int i = 0; i < 6; i++) {
-            savePageToDisk(i);
-        }
-        file.close();
+template <class K>
+struct ElementOrder<Tagged<K> > {
+    typedef typename ElementOrder<K>::Key Key;
+    bool operator()(const Tagged<K>& a, const Tagged<K>& b) const {
+        ElementOrder<K> less;
+        return less(a.key, b.key) || (!less(b.key, a.key) && a.index < b.index);
     }
+    // Solo la clave: el radix sort es estable y las etiquetas ya vienen en orden de posición
+    static Key radixKey(const Tagged<K>& value) { return ElementOrder<K>::radixKey(value.key); }
+};
 
-    int& operator[](int index) {
-        int page = index / PAGE_SIZE;
-        int offset = index % PAGE_SIZE;
 
-        for (int i = 0; i < 6; i++) {
-            if (loadedPages[i] == page) {
-                lastAccessed[i] = accessCounter++;
-                return pages[i][offset];
-            }
-        }
 
-        int replacePage = findLRUPage();
-        
-        // Guardar la página en disco si está "sucia"
-        savePageToDisk(replacePage);
+template <class T>
+struct TypeTag {
+    // Lleva un tipo de C++ como valor, para que una misma llamada pueda recibir cualquiera
+    typedef T type;
+};
+
 
-        // Cargar la nueva página en memoria
-        loadedPages[replacePage] = page;
-        lastAccessed[replacePage] = accessCounter++;
+template <class Action>
+static typename Action::result_type dispatchElement(ElementType::Kind kind, Action action) {
+    /**
+     * dispatchElement llama a action con la etiqueta TypeTag del tipo de C++ que corresponde
+     * a kind. Es el único lugar que traduce ElementType::Kind a tipos: cada operación que
+     * depende del tipo es un Action con un operator() plantilla. REC no tiene un tipo propio
+     * (los registros se ordenan por su clave), así que quien llama lo resuelve antes; si
+     * llega hasta acá es un error y el programa termina.
+     *
+     * @param ElementType::Kind kind, Action action
+     * @return lo que devuelva action
+    */
+    switch (kind) {
+    case ElementType::I32:
+        return action(TypeTag<int>());
+    case ElementType::I64:
+        return action(TypeTag<long long>());
+    case ElementType::U64:
+        return action(TypeTag<unsigned long long>());
+    case ElementType::F64:
+        return action(TypeTag<double>());
+    case ElementType::REC:
+        break;
+    }
+    // Seguir trataría los registros como si fueran de otro tipo, sin avisar
+    std::cerr << "Los registros (rec) no tienen un tipo de elemento para esta operación"
+              << std::endl;
+    exit(EXIT_FAILURE);
+}
 
-        file.seekg(page * PAGE_SIZE * sizeof(int), file.beg);
-        file.read(reinterpret_cast<char*>(pages[replacePage].data()), PAGE_SIZE * sizeof(int));
 
-        return pages[replacePage][offset];
+template <class T>
+static void textToBinary(const std::string& inputFile, const std::string& binaryFile) {
+    // Interpreta el texto por bloques y escribe los números tal cual en el archivo binario
+    TextReader in(inputFile);
+    std::ofstream out(binaryFile, std::ios::binary | std::ios::trunc);
+    std::vector<T> numbers(TEXT_CHUNK / sizeof(T));
+
+    std::size_t count;
+    while ((count = in.read(numbers.data(), numbers.size())) > 0) {
+        out.write(reinterpret_cast<char*>(numbers.data()), count * sizeof(T));
     }
+}
 
-    void markPageDirty(int index) {
-        /**
-         * markPadeDirty es la función encargada de marcar las páginas que y fueron utilizadas
-         * o editadas.
-         * 
-         * @param int index
-         * @return un valor booleano que marca cada página como verdadera si ya se utilizo y 
-         * falsa si todavía no se ha utilizado.
-        */
-        int page = index / PAGE_SIZE;
-        for (int i = 0; i < 6; i++) {
-            if (loadedPages[i] == page) {
-                dirtyPages[i] = true;
-                break;
-            }
+
+template <class T>
+static void binaryToText(const std::string& binaryFile, const std::string& textFile) {
+    // Lee los números del archivo binario por bloques y los formatea con TextWriter
+    std::ifstream in(binaryFile, std::ios::binary);
+    TextWriter out(textFile);
+    std::vector<T> numbers(TEXT_CHUNK / sizeof(T));
+
+    for (;;) {
+        in.read(reinterpret_cast<char*>(numbers.data()), numbers.size() * sizeof(T));
+        std::size_t count = static_cast<std::size_t>(in.gcount()) / sizeof(T);
+        if (count == 0) {
+            break;
         }
+        out.write(numbers.data(), count);
     }
+}
 
-    void writeToFile(int totalNumbers) {
-        for (int i = 0; i < totalNumbers; ++i) {
-            int value = (*this)[i];
-            file.seekp(i * sizeof(int));
-            file.write(reinterpret_cast<char*>(&value), sizeof(int));
-        }
+
+struct TextToBinary {
+    typedef void result_type;
+    const std::string& inputFile;
+    const std::string& binaryFile;
+
+    template <class T>
+    void operator()(TypeTag<T>) const {
+        textToBinary<T>(inputFile, binaryFile);
+    }
+};
+
+
+struct BinaryToText {
+    typedef void result_type;
+    const std::string& binaryFile;
+    const std::string& textFile;
+
+    template <class T>
+    void operator()(TypeTag<T>) const {
+        binaryToText<T>(binaryFile, textFile);
     }
 };
 
-void convertToBinary(const std::string& inputFile, const std::string& binaryFile) {
+
+void convertToBinary(const std::string& inputFile, const std::string& binaryFile,
+                     const ElementType& element) {
     /**
-     * ConvertToBinary es la función encargada de convertir los números de decimal a binario
+     * ConvertToBinary es la función encargada de convertir los números de decimal a binario.
+     * Lee el texto por bloques con TextReader y escribe los números, del tipo que diga
+     * element, en bloques del mismo tamaño. Los registros (rec) no tienen forma de texto.
      * 
-     * @param String& inputFile, String& binaryFile
+     * @param String& inputFile, String& binaryFile, ElementType& element
      * @return la cadena de números en binario
      * 
     */
-    std::ifstream in(inputFile);
-    std::ofstream out(binaryFile, std::ios::binary | std::ios::trunc);
-    int number;
-
-    while (in >> number) {
-        out.write(reinterpret_cast<char*>(&number), sizeof(int));
-        if (in.peek() == ',') {
-            in.ignore();
-        }
-    }
-
-    in.close();
-    out.close();
+    TextToBinary convert = { inputFile, binaryFile };
+    dispatchElement(element.kind, convert);
 }
 
-void convertToText(const std::string& binaryFile, const std::string& textFile) {
+void convertToText(const std::string& binaryFile, const std::string& textFile,
+                   const ElementType& element) {
     /**
      * ConvertToText es la función encargada de convertir el documento de números en binario
-     * a texto 
+     * a texto. Lee los números del tipo que diga element por bloques y los formatea con
+     * TextWriter.
      * 
-     * @param String& binaryFile, String& textFile
+     * @param String& binaryFile, String& textFile, ElementType& element
      * @return El archivo de números en binario convertidos a texto
      * 
     */
-    std::ifstream in(binaryFile, std::ios::binary);
-    std::ofstream out(textFile, std::ios::trunc);
-    int number;
+    BinaryToText convert = { binaryFile, textFile };
+    dispatchElement(element.kind, convert);
+}
 
-    bool first = true;
-    while (in.read(reinterpret_cast<char*>(&number), sizeof(int))) {
-        if (!first) {
-            out << ",";
-        } else {
-            first = false;
-        }
-        out << number;
-    }
+long long fileBytes(const std::string& filename) {
+    // Tamaño del archivo en bytes; termina el programa si no se puede abrir
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
 
-    in.close();
-    out.close();
+    if (!file.is_open()) {
+        std::cerr << "No se pudo abrir el archivo para lectura: " << filename << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    return static_cast<long long>(file.tellg());
 }
 
-int getTotalNumbersInFile(const std::string& filename) {
+long long getTotalNumbersInFile(const std::string& filename) {
     /**
      * getTotalNumbersInFile se encarga de contar todos los números separados por comas que 
      * hay en el archivo.
      * 
      * @param String& filename
-     * @return un entero llamado count con la cantidad de todos los números del archivo
+     * @return count, la cantidad de todos los números del archivo (puede pasar de 2^31)
     */
-    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    long long count = fileBytes(filename) / sizeof(int);
+    return count; 
+}
 
-    if (!file.is_open()) {
-        std::cerr << "No se pudo abrir el archivo para lectura: " << filename << std::endl;
-        exit(EXIT_FAILURE);
+template <class T>
+static long long elementsInFile(const std::string& filename) {
+    // Como getTotalNumbersInFile, pero con elementos de tipo T
+    return fileBytes(filename) / sizeof(T);
+}
+
+
+const int PARTITION_BLOCK = 256;  // elementos por bloque de partition, si la página no es más chica
+
+
+template <class Array>
+static void copyOut(Array& arr, long long first, int n, typename Array::value_type* block) {
+    // Copia n elementos desde first a block, una página a la vez
+    while (n > 0) {
+        long long pageFirst;
+        int count;
+        const typename Array::value_type* page = arr.span(first, pageFirst, count, false);
+        int len = static_cast<int>(std::min<long long>(n, pageFirst + count - first));
+        std::copy(page + (first - pageFirst), page + (first - pageFirst) + len, block);
+        first += len;
+        block += len;
+        n -= len;
     }
+}
 
-    int count = static_cast<int>(file.tellg()) / sizeof(int);
-    file.close();
-    return count; 
+
+template <class Array>
+static void copyIn(Array& arr, long long first, int n, const typename Array::value_type* block) {
+    // Copia n elementos de block al arreglo desde first, una página a la vez
+    while (n > 0) {
+        long long pageFirst;
+        int count;
+        typename Array::value_type* page = arr.span(first, pageFirst, count, true);
+        int len = static_cast<int>(std::min<long long>(n, pageFirst + count - first));
+        std::copy(block, block + len, page + (first - pageFirst));
+        first += len;
+        block += len;
+        n -= len;
+    }
 }
 
 
-int partition(PagedArray &arr, int low, int high) {
+template <class Array, class GoesLeft>
+static long long partitionBlocks(Array& arr, long long low, long long high, GoesLeft goesLeft,
+                                 typename Array::value_type* left,
+                                 typename Array::value_type* right, int blockSize) {
+    /**
+     * partitionBlocks es la partición de Hoare, pero cada lado trabaja sobre una copia de
+     * blockSize elementos: el bloque izquierdo y el derecho se copian página por
+     * página, se intercambian entre sí los elementos que están del lado equivocado y se
+     * devuelven al arreglo cuando ya no queda ninguno. Así solo se pasa por el paginador una
+     * vez por página de cada bloque y los ciclos internos recorren memoria contigua. A la
+     * izquierda quedan los elementos para los que goesLeft es verdadero; el pivote, que está
+     * en arr[high], termina entre las dos partes.
+     *
+     * @param PagedArray &arr, long long low, long long high, GoesLeft goesLeft, T* left,
+     * T* right, int blockSize
+     * @return La posición final del pivote
+    */
+    typedef typename Array::value_type T;
+    long long l = low, r = high;  // [l, r) es lo que todavía no se copió a ningún bloque
+    long long leftStart = low, rightStart = high;
+    int leftLen = 0, leftPos = 0;     // left[0, leftPos) ya van a la izquierda
+    int rightLen = 0, rightPos = -1;  // right(rightPos, rightLen) ya van a la derecha
+    // Solo los bloques con algún intercambio vuelven al arreglo: los demás dejarían sus
+    // páginas sucias sin haber cambiado nada
+    bool leftSwapped = false, rightSwapped = false;
+
+    for (;;) {
+        if (leftPos == leftLen) {
+            if (leftSwapped) {
+                copyIn(arr, leftStart, leftLen, left);
+            }
+            if (l == r) {
+                break;
+            }
+            leftStart = l;
+            leftLen = static_cast<int>(std::min<long long>(blockSize, r - l));
+            leftPos = 0;
+            leftSwapped = false;
+            l += leftLen;
+            copyOut(arr, leftStart, leftLen, left);
+        }
+        if (rightPos < 0) {
+            if (rightSwapped) {
+                copyIn(arr, rightStart, rightLen, right);
+            }
+            if (l == r) {
+                rightLen = 0;
+                break;
+            }
+            rightLen = static_cast<int>(std::min<long long>(blockSize, r - l));
+            rightStart = r - rightLen;
+            rightPos = rightLen - 1;
+            rightSwapped = false;
+            r -= rightLen;
+            copyOut(arr, rightStart, rightLen, right);
+        }
+
+        while (leftPos < leftLen && goesLeft(left[leftPos])) {
+            leftPos++;
+        }
+        while (rightPos >= 0 && !goesLeft(right[rightPos])) {
+            rightPos--;
+        }
+        if (leftPos < leftLen && rightPos >= 0) {
+            std::swap(left[leftPos++], right[rightPos--]);
+            leftSwapped = rightSwapped = true;
+        }
+    }
+
+    // Un bloque se terminó y ya no queda nada sin copiar: lo que sobra del otro bloque está
+    // entre las dos zonas ya particionadas, así que basta con particionarlo en memoria
+    long long split;
+    if (leftPos < leftLen) {
+        if (!std::is_partitioned(left + leftPos, left + leftLen, goesLeft)) {
+            std::partition(left + leftPos, left + leftLen, goesLeft);
+            leftSwapped = true;
+        }
+        T* middle = std::partition_point(left + leftPos, left + leftLen, goesLeft);
+        if (leftSwapped) {
+            copyIn(arr, leftStart, leftLen, left);
+        }
+        split = leftStart + (middle - left);
+    } else if (rightLen > 0) {
+        if (!std::is_partitioned(right, right + rightPos + 1, goesLeft)) {
+            std::partition(right, right + rightPos + 1, goesLeft);
+            rightSwapped = true;
+        }
+        T* middle = std::partition_point(right, right + rightPos + 1, goesLeft);
+        if (rightSwapped) {
+            copyIn(arr, rightStart, rightLen, right);
+        }
+        split = rightStart + (middle - right);
+    } else {
+        split = l;
+    }
+
+    arr.swap(split, high);
+    return split;
+}
+
+
+template <class Array, class Less>
+long long partition(Array &arr, long long low, long long high, Less less,
+                    std::vector<typename Array::value_type>& blocks, bool orEqual = false) {
     /**
      * partion es la función encargada del movimiento de los elementos al momento de
      * realizar el QuickSort
+     *
+     * El pivote es arr[high]: a la izquierda quedan los menores según less y a la derecha
+     * los mayores o iguales. Con orEqual los iguales al pivote también van a la izquierda.
+     * Cada caso es su propia instancia de partitionBlocks, sin ramas en el ciclo interno.
+     * blocks tiene lugar para los dos bloques de partitionBlocks, uno detrás del otro.
      * 
-     * @param PagedArray &arr, int low, int high
-     * @return El valor de i y a su vez markPageDirty
+     * @param PagedArray &arr, long long low, long long high, Less less, vector<T>& blocks,
+     * bool orEqual
+     * @return La posición final del pivote
+    */
+    typedef typename Array::value_type T;
+    const T pivot = arr[high];
+    const int blockSize = static_cast<int>(blocks.size() / 2);
+    T* left = blocks.data();
+    T* right = left + blockSize;
+    if (orEqual) {
+        return partitionBlocks(arr, low, high,
+                               [&less, &pivot](const T& value) { return !less(pivot, value); },
+                               left, right, blockSize);
+    }
+    return partitionBlocks(arr, low, high,
+                           [&less, &pivot](const T& value) { return less(value, pivot); },
+                           left, right, blockSize);
+}
+
+template <class Array, class Less>
+static void heapSort(Array& arr, long long low, long long high, Less less) {
+    /**
+     * heapSort ordena arr[low..high] con un montículo de máximos. quickSort lo usa cuando un
+     * rango pasa el límite de profundidad: es más lento por el acceso disperso a las
+     * páginas, pero garantiza n log n.
+     *
+     * @param PagedArray& arr, long long low, long long high, Less less
+    */
+    typedef typename Array::value_type T;
+    const long long n = high - low + 1;
+    auto siftDown = [&arr, &less, low](long long root, long long end) {
+        T value = arr[low + root];
+        for (long long child = 2 * root + 1; child < end; child = 2 * root + 1) {
+            T childValue = arr[low + child];
+            if (child + 1 < end) {
+                T rightValue = arr[low + child + 1];
+                if (less(childValue, rightValue)) {
+                    child++;
+                    childValue = rightValue;
+                }
+            }
+            if (!less(value, childValue)) {
+                break;
+            }
+            arr[low + root] = childValue;
+            root = child;
+        }
+        arr[low + root] = value;
+    };
+    for (long long i = n / 2 - 1; i >= 0; i--) {
+        siftDown(i, n);
+    }
+    for (long long end = n - 1; end > 0; end--) {
+        arr.swap(low, low + end);
+        siftDown(0, end);
+    }
+}
+
+
+template <class Array, class Less>
+static long long medianOf(Array& arr, long long a, long long b, long long c, Less less) {
+    // Posición de la mediana entre arr[a], arr[b] y arr[c]
+    typedef typename Array::value_type T;
+    T x = arr[a], y = arr[b], z = arr[c];
+    if (!less(y, x) == !less(z, y)) {
+        return b;
+    }
+    if (!less(x, y) == !less(z, x)) {
+        return a;
+    }
+    return c;
+}
+
+
+template <class Array, class Less>
+static void medianToHigh(Array& arr, long long low, long long high, Less less) {
+    /**
+     * medianToHigh deja en arr[high] el pivote: la mediana de tres elementos, o en rangos
+     * grandes la mediana de las medianas de tres grupos de tres (así las entradas en
+     * montaña o intercaladas no caen siempre en el peor caso).
+     *
+     * @param PagedArray& arr, long long low, long long high, Less less
     */
-    int pivot = arr[high];
-    int i = (low - 1);
-    
-    for (int j = low; j <= high - 1; j++) {
-        if (arr[j] < pivot) {
-            i++;
-            std::swap(arr[i], arr[j]);
-            arr.markPageDirty(i);
-            arr.markPageDirty(j);
+    long long mid = low + (high - low) / 2;
+    long long pivot;
+    if (high - low < 1024) {
+        pivot = medianOf(arr, low, mid, high, less);
+    } else {
+        long long step = (high - low) / 8;
+        pivot = medianOf(arr, medianOf(arr, low, low + step, low + 2 * step, less),
+                         medianOf(arr, mid - step, mid, mid + step, less),
+                         medianOf(arr, high - 2 * step, high - step, high, less), less);
+    }
+    if (pivot != high) {
+        arr.swap(pivot, high);
+    }
+}
+
+
+template <class Array, class Less>
+static bool isSorted(Array& arr, long long low, long long high, Less less) {
+    // Recorre arr[low..high] página por página hasta el primer par fuera de orden
+    typedef typename Array::value_type T;
+    T previous = arr[low];
+    for (long long j = low + 1; j <= high; ) {
+        long long first;
+        int count;
+        const T* page = arr.span(j, first, count, false);
+        int end = static_cast<int>(std::min<long long>(count, high - first + 1));
+        for (int k = static_cast<int>(j - first); k < end; k++) {
+            if (less(page[k], previous)) {
+                return false;
+            }
+            previous = page[k];
         }
+        j = first + end;
     }
-    std::swap(arr[i + 1], arr[high]);
-    arr.markPageDirty(i + 1);
-    arr.markPageDirty(high);
-    return (i + 1);
+    return true;
 }
 
-void quickSort(PagedArray &arr, int low, int high) {
+
+template <class Array, class Less>
+void quickSort(Array &arr, long long low, long long high, Less less) {
     /**
      * quickSort uno de los algoritmos de ordenamiento que hay que implementar en la solución 
      * del ejercicio
+     *
+     * Es iterativo: de cada partición se guarda en la pila la parte más grande y se sigue
+     * con la más chica, así la pila nunca pasa de log2(n) rangos. El pivote es la mediana de
+     * tres. Si el elemento justo antes del rango es igual al pivote, el pivote es el mínimo
+     * del rango; entonces los iguales se mandan todos a la izquierda y solo se sigue con la
+     * derecha, para que los valores repetidos no degraden el ordenamiento. Un rango que pasa
+     * de 2·log2(n) particiones se termina con heapSort. Cuando el rango cabe en una sola
+     * página se ordena ahí mismo con std::sort, sin volver a pasar por el paginador. Todas
+     * las comparaciones pasan por less. Un rango que ya está en orden no se particiona: así
+     * una entrada ordenada no escribe ninguna página. Los bloques de partition son de una
+     * página como mucho y quien llama se los descuenta a los marcos del arreglo (ver
+     * PARTITION_FRAMES).
      * 
-     * @param PagedArray &arr, int low, int high
+     * @param PagedArray &arr, long long low, long long high, Less less
      * @return El archivo con los números ya en el orden correspondiente
     */
-    if (low < high) {
-        int pi = partition(arr, low, high);
-        quickSort(arr, low, pi - 1);
-        quickSort(arr, pi + 1, high);
+    typedef typename Array::value_type T;
+    struct Range {
+        long long low, high;
+        int depth;  // particiones que le quedan antes de pasar a heapSort
+    };
+    int depthLimit = 0;
+    for (long long n = high - low + 1; n > 1; n >>= 1) {
+        depthLimit += 2;
+    }
+    const long long start = low;
+    std::vector<T> blocks(2 * std::min(PARTITION_BLOCK, arr.pageSize()));
+    std::vector<Range> pending;
+    int depth = depthLimit;
+    for (;;) {
+        while (low < high) {
+            long long first;
+            int count;
+            T* page = arr.span(low, first, count, false);
+            if (high < first + count) {
+                // Una página ya ordenada no se toca, para que no quede sucia
+                if (!std::is_sorted(page + (low - first), page + (high - first) + 1, less)) {
+                    page = arr.span(low, first, count, true);
+                    std::sort(page + (low - first), page + (high - first) + 1, less);
+                }
+                break;
+            }
+            // Mover el pivote ensuciaría páginas de un rango que ya está en orden
+            if (isSorted(arr, low, high, less)) {
+                break;
+            }
+            if (depth == 0) {
+                heapSort(arr, low, high, less);
+                break;
+            }
+            depth--;
+
+            medianToHigh(arr, low, high, less);
+            // Todo lo que está antes de low es menor o igual que el rango: si no es menor
+            // que el pivote, es igual
+            if (low > start && !less(arr[low - 1], arr[high])) {
+                low = partition(arr, low, high, less, blocks, true) + 1;
+                continue;
+            }
+            long long pi = partition(arr, low, high, less, blocks);
+            if (pi - low < high - pi) {
+                pending.push_back(Range{pi + 1, high, depth});
+                high = pi - 1;
+            } else {
+                pending.push_back(Range{low, pi - 1, depth});
+                low = pi + 1;
+            }
+        }
+        if (pending.empty()) {
+            return;
+        }
+        low = pending.back().low;
+        high = pending.back().high;
+        depth = pending.back().depth;
+        pending.pop_back();
     }
 }
 
@@ -234,150 +647,1377 @@ void quickSort(PagedArray &arr, int low, int high) {
 
 
 
-void insertionSort(PagedArray& arr, int n) {
+template <class Array, class Less>
+void insertionSort(Array& arr, long long n, Less less) {
     /**
      * InsertionSort es uno de los algoritmos de ordenamientos que hay que implementar en la
      * solución del ejercicio
      * 
-     * @param PagedArray& arr, int n
-     * @return los números en orden y a su vez marca la pagina como sucia con el 
-     * markPageDirty
-    */
-    for (int i = 1; i < n; i++) {
-        int key = arr[i];
-        int j = i - 1;
-        while (j >= 0 && arr[j] > key) {
-            arr[j + 1] = arr[j];
-            
-            // Marcar página como "sucia" después de la escritura
-            arr.markPageDirty(j + 1);
-            
-            j = j - 1;
+     * Los corrimientos se hacen directo sobre la página mientras el hueco y el elemento que
+     * se corre estén en la misma; solo el paso de una página a la anterior pasa por el
+     * paginador elemento por elemento.
+     * 
+     * @param PagedArray& arr, long long n, Less less
+     * @return los números en orden
+    */
+    typedef typename Array::value_type T;
+    for (long long i = 1; i < n; i++) {
+        T key = arr[i];
+        long long j = i - 1;  // el hueco está en j + 1
+        while (j >= 0) {
+            long long first;
+            int count;
+            T* page = arr.span(j, first, count, false);
+            int k = static_cast<int>(j - first);
+            if (!less(key, page[k])) {
+                break;
+            }
+            if (j + 1 == first + count) {
+                // El hueco está en la página siguiente
+                arr[j + 1] = page[k];
+                j--;
+                continue;
+            }
+            page = arr.span(j, first, count, true);
+            while (k >= 0 && less(key, page[k])) {
+                page[k + 1] = page[k];
+                k--;
+            }
+            j = first + k;
+            if (k >= 0) {
+                break;
+            }
         }
         arr[j + 1] = key;
-        
-        // Marcar página como "sucia" después de la escritura
-        arr.markPageDirty(j + 1);
     }
 }
 
 
-void selectionSort(PagedArray& arr, int n) {
+template <class Array, class Less>
+void selectionSort(Array& arr, long long n, Less less) {
     /**
      * seleciontSort es uno de los algoritmos de ordenamiento que hay que implementar en la 
      * solución del ejercicio
      * 
-     * @param pagedArray& arr, int n
-     * @return los números en el orden correspondiente y marca las páginas como sucias con 
-     * el markPageDirty
+     * @param pagedArray& arr, long long n, Less less
+     * @return los números en el orden correspondiente
     */
-    for (int i = 0; i < n-1; i++) {
-        int min_idx = i;
-        for (int j = i+1; j < n; j++) {
-            if (arr[j] < arr[min_idx]) {
-                min_idx = j;
+    typedef typename Array::value_type T;
+    for (long long i = 0; i < n-1; i++) {
+        long long min_idx = i;
+        T min_value = arr[i];
+        // Buscar el mínimo página por página
+        for (long long j = i+1; j < n; ) {
+            long long first;
+            int count;
+            const T* page = arr.span(j, first, count, false);
+            for (int k = static_cast<int>(j - first); k < count; k++) {
+                bool smaller = less(page[k], min_value);
+                min_idx = smaller ? first + k : min_idx;
+                min_value = smaller ? page[k] : min_value;
             }
+            j = first + count;
         }
-        std::swap(arr[min_idx], arr[i]);
-
-        // Marcar páginas como "sucias" después del intercambio
-        arr.markPageDirty(min_idx);
-        arr.markPageDirty(i);
+        arr.swap(min_idx, i);
     }
 }
 
 
-void bubbleSort(PagedArray& arr, int n) {
+template <class Array, class Less>
+void bubbleSort(Array& arr, long long n, Less less) {
     /**
      * bubbleSort es el algoritmo de ordenamient propuesto para solución del ejercicio
      * 
-     * @param PagedArray& arr, int n
-     * @return los números en el orden correspondiente y marca las paginas como sucias con 
-     * el markPageDirty 
+     * @param PagedArray& arr, long long n, Less less
+     * @return los números en el orden correspondiente
+    */
+    typedef typename Array::value_type T;
+    for (long long i = 0; i < n-1; i++) {
+        long long end = n-i-1;  // la pasada compara j con j+1 para j < end
+        for (long long j = 0; j < end; ) {
+            long long first;
+            int count;
+            T* page = arr.span(j, first, count, false);
+            long long last = std::min(first + count - 1, end);  // j + 1 sigue en la página
+            bool dirty = false;
+            for (int k = static_cast<int>(j - first); first + k < last; k++) {
+                T left = page[k];
+                T right = page[k+1];
+                bool swapped = less(right, left);
+                page[k] = swapped ? right : left;
+                page[k+1] = swapped ? left : right;
+                dirty |= swapped;
+            }
+            if (dirty) {
+                arr.span(j, first, count, true);
+            }
+            j = last;
+            if (j < end) {
+                // j es el último de su página y j + 1 está en la siguiente
+                T left = arr[j];
+                T right = arr[j+1];
+                if (less(right, left)) {
+                    arr.swap(j, j+1);
+                }
+                j++;
+            }
+        }
+    }
+}
+
+
+
+template <class T>
+struct RunCursor {
+    /*RunCursor lee una corrida ordenada del archivo de página en página durante la mezcla
+     * para que nunca haya más de una página de cada corrida en memoria.
+    */
+    long long next;  // siguiente posición (en elementos) por leer del archivo
+    long long end;   // posición donde termina la corrida
+    std::vector<T> page;
+    int pos = 0;
+    int len = 0;
+
+    bool exhausted() const {
+        return pos == len;
+    }
+
+    const T& head() const {
+        return page[pos];
+    }
+
+    void refill(std::ifstream& in) {
+        len = static_cast<int>(std::min<long long>(page.size(), end - next));
+        pos = 0;
+        if (len > 0) {
+            in.clear();
+            in.seekg(next * sizeof(T), in.beg);
+            in.read(reinterpret_cast<char*>(page.data()), len * sizeof(T));
+            next += len;
+        }
+    }
+
+    void advance(std::ifstream& in) {
+        if (++pos == len) {
+            refill(in);
+        }
+    }
+};
+
+
+template <class T>
+struct SliceCursor {
+    /*SliceCursor recorre un tramo ordenado que ya está en memoria; sirve para mezclar con el
+     * mismo LoserTree sin pasar por el archivo.
+    */
+    const T* pos;
+    const T* end;
+
+    bool exhausted() const {
+        return pos == end;
+    }
+
+    const T& head() const {
+        return *pos;
+    }
+};
+
+
+template <class Run, class Less>
+class LoserTree {
+    /*LoserTree es el árbol de perdedores que escoge en cada paso la corrida con el menor
+     * elemento según less. Cada nodo interno guarda la corrida que perdió su comparación y
+     * tree[0] a la ganadora, así reemplazar la cabeza solo recorre un camino de log k nodos.
     */
-    for (int i = 0; i < n-1; i++) {
-        for (int j = 0; j < n-i-1; j++) {
-            if (arr[j] > arr[j+1]) {
-                std::swap(arr[j], arr[j+1]);
+    std::vector<int> tree;
+    std::vector<Run>& runs;
+    int k;
+    Less less;
+
+    bool beats(int a, int b) const {
+        if (runs[a].exhausted()) {
+            return false;
+        }
+        if (runs[b].exhausted()) {
+            return true;
+        }
+        return less(runs[a].head(), runs[b].head());
+    }
+
+    int build(int node) {
+        if (node >= k) {
+            return node - k;
+        }
+        int left = build(2 * node);
+        int right = build(2 * node + 1);
+        if (beats(left, right)) {
+            tree[node] = right;
+            return left;
+        }
+        tree[node] = left;
+        return right;
+    }
+
+public:
+    LoserTree(std::vector<Run>& runs, int k, Less less)
+        : tree(std::max(k, 1)), runs(runs), k(k), less(less) {
+        tree[0] = build(1);
+    }
 
-                // Marcar páginas como "sucias" después del intercambio
-                arr.markPageDirty(j);
-                arr.markPageDirty(j+1);
+    int winner() const {
+        return tree[0];
+    }
+
+    void replay() {
+        // La ganadora cambió de cabeza: volver a jugar su camino hasta la raíz
+        int current = tree[0];
+        for (int node = (current + k) / 2; node > 0; node /= 2) {
+            if (beats(tree[node], current)) {
+                std::swap(tree[node], current);
             }
         }
+        tree[0] = current;
+    }
+};
+
+
+template <class Task>
+static void parallelFor(int count, Task task) {
+    /**
+     * parallelFor corre task(0), ..., task(count - 1), cada una en su propio hilo (la última
+     * en el hilo actual), y espera a que terminen todas.
+     *
+     * @param int count, Task task
+    */
+    std::vector<std::thread> workers;
+    for (int i = 0; i + 1 < count; i++) {
+        workers.emplace_back(task, i);
+    }
+    if (count > 0) {
+        task(count - 1);
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
     }
 }
 
 
+class WorkerPool {
+    /*WorkerPool mantiene threads - 1 hilos vivos durante todo un ordenamiento, para no crear
+     * y esperar hilos nuevos en cada bloque. run reparte los índices de una tarea entre esos
+     * hilos y el hilo que llama, y vuelve cuando se terminaron todos.
+    */
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::function<void(int)> task;
+    int next = 0;        // siguiente índice sin tomar
+    int count = 0;       // índices de la tarea actual
+    int unfinished = 0;  // índices que todavía no terminan
+    long long round = 0;  // cambia con cada tarea nueva
+    bool stopping = false;
 
-int main(int argc, char* argv[]) {
-    if (argc != 7) {
-        std::cerr << "Uso incorrecto. La sintaxis correcta es:\n";
-        std::cerr << "paged-sort -i <archivo> -a {QS|IS|SS|PS} -o <archivo_resultado>\n";
-        return EXIT_FAILURE;
+    bool take(int& index) {
+        // Toma el siguiente índice de la tarea actual; el candado tiene que estar tomado
+        if (next == count) {
+            return false;
+        }
+        index = next++;
+        return true;
     }
 
-    std::string inputFile, outputFile, algorithm;
+    void work(std::unique_lock<std::mutex>& lock) {
+        // Corre índices de la tarea actual hasta que no quede ninguno sin tomar
+        int index;
+        while (take(index)) {
+            lock.unlock();
+            task(index);
+            lock.lock();
+            if (--unfinished == 0) {
+                finished.notify_all();
+            }
+        }
+    }
 
-    for (int i = 1; i < argc; i += 2) {
-        if (std::string(argv[i]) == "-i") {
-            inputFile = argv[i + 1];
-        } else if (std::string(argv[i]) == "-o") {
-            outputFile = argv[i + 1];
-        } else if (std::string(argv[i]) == "-a") {
-            algorithm = argv[i + 1];
-        } else {
-            std::cerr << "Argumento no reconocido: " << argv[i] << "\n";
-            return EXIT_FAILURE;
+    void loop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        long long seen = 0;
+        for (;;) {
+            wake.wait(lock, [this, seen] { return stopping || round != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = round;
+            work(lock);
         }
     }
 
-    if (inputFile.empty() || outputFile.empty() || algorithm.empty()) {
-        std::cerr << "Error en los argumentos proporcionados.\n";
-        return EXIT_FAILURE;
+public:
+    explicit WorkerPool(int threads) {
+        for (int i = 1; i < threads; i++) {
+            workers.emplace_back(&WorkerPool::loop, this);
+        }
     }
 
-    std::string binaryFile = "temp_binary_file.bin";
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
 
-    // Convertir el archivo de entrada a binario
-    convertToBinary(inputFile, binaryFile);    { 
+    template <class Task>
+    void run(int tasks, Task body) {
+        /**
+         * run corre body(0), ..., body(tasks - 1) repartidas entre los hilos y espera a que
+         * terminen todas. Con un solo índice o sin hilos extra corre todo en el hilo actual.
+         *
+         * @param int tasks, Task body
+        */
+        if (tasks <= 1 || workers.empty()) {
+            for (int i = 0; i < tasks; i++) {
+                body(i);
+            }
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        task = body;
+        next = 0;
+        count = tasks;
+        unfinished = tasks;
+        round++;
+        wake.notify_all();
+        work(lock);
+        finished.wait(lock, [this] { return unfinished == 0; });
+    }
+};
+
+
+static void countRunIO(const PagingConfig& config, long long bytesRead, long long bytesWritten) {
+    /**
+     * countRunIO suma a las estadísticas la E/S del merge sort, que no pasa por PagedArray.
+     *
+     * @param PagingConfig& config, long long bytesRead, long long bytesWritten
+    */
+    if (config.stats) {
+        std::lock_guard<std::mutex> guard(statsMutex);
+        config.stats->bytesRead += bytesRead;
+        config.stats->bytesWritten += bytesWritten;
+    }
+}
+
+
+static int workerThreads(const PagingConfig& config, int needed = 2) {
+    /**
+     * workerThreads es la cantidad de hilos que se usan de verdad: cada uno recibe
+     * frames / hilos marcos y necesita al menos needed para ordenar además de los de E/S.
+     *
+     * @param PagingConfig& config, int needed
+     * @return entre 1 y config.threads
+    */
+    return std::max(1, std::min(config.threads, config.frames / (ioFrames(config) + needed)));
+}
 
 
-    PagedArray array(binaryFile);
-    int totalNumbers = getTotalNumbersInFile(binaryFile);
+template <class T, class Less>
+static void sortSlices(WorkerPool& pool, T* data, long long len, long long slice, Less less) {
+    /**
+     * sortSlices ordena por separado cada tramo de slice elementos de data, repartiendo los
+     * tramos entre los hilos de pool. El último tramo puede quedar más corto.
+     *
+     * @param WorkerPool& pool, T* data, long long len, long long slice, Less less
+    */
+    int count = static_cast<int>((len + slice - 1) / slice);
+    pool.run(count, [=](int i) {
+        std::sort(data + i * slice, data + std::min(len, (i + 1) * slice), less);
+    });
+}
+
+
+template <class T>
+struct BinaryOutput {
+    /*BinaryOutput escribe los elementos tal cual en un archivo binario; es la salida de las
+     * pasadas intermedias de la mezcla (la final puede ir directo a un TextWriter).
+    */
+    std::ofstream& out;
+
+    void write(const T* numbers, std::size_t count) {
+        out.write(reinterpret_cast<const char*>(numbers), count * sizeof(T));
+    }
+};
+
+
+template <class T, class Output, class Less>
+static void mergeRuns(std::ifstream& in, Output& out, std::vector<RunCursor<T> >& runs,
+                      int k, std::vector<T>& outPage, Less less) {
+    /**
+     * mergeRuns mezcla k corridas ya posicionadas en runs y escribe el resultado de forma
+     * secuencial en out, usando una sola página de salida.
+     *
+     * @param std::ifstream& in, Output& out, std::vector<RunCursor>& runs, int k,
+     * std::vector<T>& outPage, Less less
+     * @return las k corridas mezcladas en una sola corrida ordenada dentro de out
+    */
+    for (int r = 0; r < k; r++) {
+        runs[r].refill(in);
+    }
+
+    LoserTree<RunCursor<T>, Less> tree(runs, k, less);
+    int filled = 0;
+
+    while (!runs[tree.winner()].exhausted()) {
+        RunCursor<T>& run = runs[tree.winner()];
+        outPage[filled++] = run.head();
+        if (filled == static_cast<int>(outPage.size())) {
+            out.write(outPage.data(), filled);
+            filled = 0;
+        }
+        run.advance(in);
+        tree.replay();
+    }
+
+    out.write(outPage.data(), filled);
+}
+
+
+template <class T, class Output, class Less>
+static void mergePass(const std::string& source, Output& out, long long totalNumbers,
+                      long long runLength, const PagingConfig& config, Less less) {
+    /**
+     * mergePass hace una pasada de mezcla: junta las corridas de runLength elementos de
+     * source de frames - 1 en frames - 1 y escribe las corridas resultantes en out.
+     *
+     * @param String& source, Output& out, long long totalNumbers, long long runLength,
+     * PagingConfig& config, Less less
+    */
+    const int fanIn = config.frames - 1;
+    std::vector<RunCursor<T> > runs(fanIn);
+    std::vector<T> outPage(pageElements<T>(config));
+    for (int r = 0; r < fanIn; r++) {
+        runs[r].page.resize(pageElements<T>(config));
+    }
+
+    std::ifstream in(source, std::ios::binary);
+    for (long long groupStart = 0; groupStart < totalNumbers; groupStart += runLength * fanIn) {
+        int k = 0;
+        for (long long start = groupStart;
+             k < fanIn && start < totalNumbers; start += runLength, k++) {
+            runs[k].next = start;
+            runs[k].end = std::min(start + runLength, totalNumbers);
+        }
+        mergeRuns(in, out, runs, k, outPage, less);
+    }
+}
+
+
+template <class T, class Less>
+static std::string mergeUntil(const std::string& runsFile, long long totalNumbers,
+                              long long& runLength, long long target,
+                              const PagingConfig& config, Less less) {
+    /**
+     * mergeUntil repite pasadas de mezcla alternando entre runsFile y un archivo auxiliar
+     * hasta que las corridas midan al menos target elementos. Borra el archivo que no queda
+     * con el resultado.
+     *
+     * @param String& runsFile, long long totalNumbers, long long& runLength,
+     * long long target, PagingConfig& config, Less less
+     * @return el archivo donde quedaron las corridas; runLength queda con su nuevo largo
+    */
+    const int fanIn = config.frames - 1;
+    std::string source = runsFile;
+    std::string scratch = runsFile + ".runs";
+
+    for (; runLength < target; runLength *= fanIn) {
+        std::ofstream file(scratch, std::ios::binary | std::ios::trunc);
+        BinaryOutput<T> out = { file };
+        mergePass<T>(source, out, totalNumbers, runLength, config, less);
+        file.close();
+        countRunIO(config, totalNumbers * sizeof(T), totalNumbers * sizeof(T));
+        std::swap(source, scratch);
+    }
+
+    std::remove(scratch.c_str());
+    return source;
+}
+
+
+template <class T, class Less>
+static void mergeSortedRuns(const std::string& binaryFile, long long totalNumbers,
+                            long long runLength, const PagingConfig& config, Less less) {
+    /**
+     * mergeSortedRuns mezcla las corridas ordenadas de runLength elementos de binaryFile
+     * hasta que quede una sola, y la deja en binaryFile.
+     *
+     * @param String& binaryFile, long long totalNumbers, long long runLength,
+     * PagingConfig& config, Less less
+    */
+    std::string result = mergeUntil<T>(binaryFile, totalNumbers, runLength, totalNumbers,
+                                       config, less);
+    if (result != binaryFile) {
+        std::remove(binaryFile.c_str());
+        std::rename(result.c_str(), binaryFile.c_str());
+    }
+}
+
+
+template <class T, class Less>
+static void externalMergeSort(const std::string& binaryFile, const PagingConfig& config,
+                              Less less) {
+    /**
+     * externalMergeSort ordena el archivo binario con un merge sort externo de k vías. Primero
+     * genera corridas ordenadas del tamaño de todas las páginas disponibles y luego las mezcla
+     * de frames - 1 en frames - 1 leyendo cada corrida de forma secuencial, con una página de
+     * entrada por corrida y una de salida. Nunca hay más de config.frames páginas en memoria,
+     * el mismo límite que respeta PagedArray.
+     *
+     * @param String& binaryFile, PagingConfig& config, Less less
+     * @return El archivo binario con los números en el orden correspondiente
+    */
+    const long long totalNumbers = elementsInFile<T>(binaryFile);
+    const int threads = workerThreads(config);
+    // Con varios hilos cada uno ordena su tramo del bloque: las corridas salen más cortas,
+    // pero el bloque sigue cabiendo en el presupuesto de páginas
+    const long long runLength =
+        static_cast<long long>(config.frames) * pageElements<T>(config) / threads;
+    const long long block = runLength * threads;
+    WorkerPool pool(threads);
+
+    // Fase 1: ordenar en memoria bloques que caben en el presupuesto de páginas
+    {
+        std::fstream file(binaryFile, std::ios::in | std::ios::out | std::ios::binary);
+        std::vector<T> buffer(block);
+        for (long long start = 0; start < totalNumbers; start += block) {
+            long long len = std::min(block, totalNumbers - start);
+            file.seekg(start * sizeof(T), file.beg);
+            file.read(reinterpret_cast<char*>(buffer.data()), len * sizeof(T));
+            sortSlices(pool, buffer.data(), len, runLength, less);
+            file.seekp(start * sizeof(T), file.beg);
+            file.write(reinterpret_cast<char*>(buffer.data()), len * sizeof(T));
+        }
+        countRunIO(config, totalNumbers * sizeof(T), totalNumbers * sizeof(T));
+    }
+
+    // Fase 2: mezclar corridas de fanIn en fanIn alternando entre dos archivos
+    mergeSortedRuns<T>(binaryFile, totalNumbers, runLength, config, less);
+}
+
+
+void externalMergeSort(const std::string& binaryFile, const PagingConfig& config) {
+    /**
+     * externalMergeSort ordena el archivo binario con el merge sort externo, con elementos
+     * del tipo de config.element.
+     *
+     * @param String& binaryFile, PagingConfig& config
+    */
+    sortBinaryFile(binaryFile, "MS", config);
+}
+
+
+template <class T>
+static void radixSort(const std::string& binaryFile, const PagingConfig& config) {
+    /**
+     * radixSort ordena el archivo binario con un radix sort LSD. Cada pasada lee el archivo
+     * de forma secuencial con un marco y reparte los números en cubetas según un dígito de
+     * la clave (ElementOrder<T>::radixKey); cada cubeta tiene un búfer del tamaño de una
+     * página que se escribe entero en la zona de la cubeta dentro del archivo de salida. Los
+     * búferes salen del resto de los marcos, así que el dígito tiene tantos bits como
+     * permita frames - 1 (hasta 16) y con más memoria se hacen menos pasadas: con claves de
+     * 32 bits son 32 con 3 marcos y 4 con 257. Una pasada de conteo inicial arma los
+     * histogramas de todos los dígitos y se saltan las pasadas en las que todos los números
+     * caen en la misma cubeta.
+     *
+     * @param String& binaryFile, PagingConfig& config
+     * @return El archivo binario con los números en el orden correspondiente
+    */
+    typedef typename ElementOrder<T>::Key Key;
+    const long long totalNumbers = elementsInFile<T>(binaryFile);
+    const int pageSize = pageElements<T>(config);
+    const int keyBits = 8 * sizeof(Key);
+
+    int maxBits = 1;
+    while (maxBits < 16 && (2LL << maxBits) <= config.frames - 1) {
+        maxBits++;
+    }
+    const int passes = (keyBits + maxBits - 1) / maxBits;
+    const int bits = (keyBits + passes - 1) / passes;
+    const int buckets = 1 << bits;
+    const Key mask = buckets - 1;
+
+    std::vector<T> page(pageSize);
+
+    // Pasada de conteo: los histogramas de todos los dígitos de una vez
+    std::vector<std::vector<long long> > counts(passes, std::vector<long long>(buckets, 0));
+    {
+        std::ifstream in(binaryFile, std::ios::binary);
+        for (long long start = 0; start < totalNumbers; start += pageSize) {
+            int len = static_cast<int>(std::min<long long>(pageSize, totalNumbers - start));
+            in.read(reinterpret_cast<char*>(page.data()), len * sizeof(T));
+            for (int k = 0; k < len; k++) {
+                Key key = ElementOrder<T>::radixKey(page[k]);
+                for (int pass = 0; pass < passes; pass++) {
+                    counts[pass][(key >> (pass * bits)) & mask]++;
+                }
+            }
+        }
+        countRunIO(config, totalNumbers * sizeof(T), 0);
+    }
+
+    std::string source = binaryFile;
+    std::string target = binaryFile + ".radix";
+    std::vector<T> buffers(static_cast<long long>(buckets) * pageSize);
+    std::vector<int> filled(buckets);
+    std::vector<long long> next(buckets);
+
+    for (int pass = 0; pass < passes; pass++) {
+        const int shift = pass * bits;
+        if (std::find(counts[pass].begin(), counts[pass].end(), totalNumbers)
+            != counts[pass].end()) {
+            continue;  // el dígito es igual en todos: la pasada no cambiaría nada
+        }
+
+        // Dónde empieza cada cubeta en el archivo de salida
+        long long offset = 0;
+        for (int b = 0; b < buckets; b++) {
+            next[b] = offset;
+            offset += counts[pass][b];
+            filled[b] = 0;
+        }
+
+        std::ifstream in(source, std::ios::binary);
+        std::ofstream out(target, std::ios::binary | std::ios::trunc);
+        auto flush = [&](int b) {
+            out.seekp(next[b] * sizeof(T), out.beg);
+            out.write(reinterpret_cast<char*>(&buffers[static_cast<long long>(b) * pageSize]),
+                      filled[b] * sizeof(T));
+            next[b] += filled[b];
+            filled[b] = 0;
+        };
+
+        for (long long start = 0; start < totalNumbers; start += pageSize) {
+            int len = static_cast<int>(std::min<long long>(pageSize, totalNumbers - start));
+            in.read(reinterpret_cast<char*>(page.data()), len * sizeof(T));
+            for (int k = 0; k < len; k++) {
+                int b = static_cast<int>((ElementOrder<T>::radixKey(page[k]) >> shift) & mask);
+                buffers[static_cast<long long>(b) * pageSize + filled[b]] = page[k];
+                if (++filled[b] == pageSize) {
+                    flush(b);
+                }
+            }
+        }
+        for (int b = 0; b < buckets; b++) {
+            if (filled[b] > 0) {
+                flush(b);
+            }
+        }
+        out.close();
+        countRunIO(config, totalNumbers * sizeof(T), totalNumbers * sizeof(T));
+        std::swap(source, target);
+    }
+
+    if (source != binaryFile) {
+        std::remove(binaryFile.c_str());
+        std::rename(source.c_str(), binaryFile.c_str());
+    } else {
+        std::remove(target.c_str());
+    }
+}
+
+
+void radixSort(const std::string& binaryFile, const PagingConfig& config) {
+    /**
+     * radixSort ordena el archivo binario con el radix sort LSD, con elementos del tipo de
+     * config.element.
+     *
+     * @param String& binaryFile, PagingConfig& config
+    */
+    sortBinaryFile(binaryFile, "RS", config);
+}
+
+
+template <class T, class Less>
+static void mergeSortText(const std::string& inputFile, const std::string& outputFile,
+                          const std::string& binaryFile, const PagingConfig& config, Less less) {
+    /**
+     * mergeSortText es el merge sort externo sin el viaje de ida y vuelta por el archivo
+     * binario: el texto se interpreta directo en el búfer de corridas y la última mezcla
+     * se formatea directo al archivo de salida. Si todo cabe en el presupuesto de páginas
+     * no se crea ningún archivo temporal.
+     *
+     * @param String& inputFile, String& outputFile, String& binaryFile, PagingConfig& config,
+     * Less less
+     * @return El archivo de salida con los números en el orden correspondiente
+    */
+    const int threads = workerThreads(config);
+    const long long runLength =
+        static_cast<long long>(config.frames) * pageElements<T>(config) / threads;
+    const long long budget = runLength * threads;
+    const int fanIn = config.frames - 1;
+    TextReader reader(inputFile);
+    std::vector<T> buffer(budget);
+    WorkerPool pool(threads);
+
+    // Fase 1: las corridas salen directo del texto
+    long long len = 0;
+    long long totalNumbers = 0;
+    std::size_t count;
+    std::ofstream runs;
+    for (;;) {
+        while (len < budget && (count = reader.read(buffer.data() + len, budget - len)) > 0) {
+            len += count;
+        }
+        // Un número de más dice si el texto sigue después de llenar el búfer
+        T extra;
+        bool more = len == budget && reader.read(&extra, 1) == 1;
+
+        sortSlices(pool, buffer.data(), len, runLength, less);
+        if (!more && totalNumbers == 0) {
+            // Todo cupo en memoria: mezclar los tramos de cada hilo directo al texto
+            TextWriter out(outputFile);
+            if (len <= runLength) {
+                out.write(buffer.data(), len);
+                return;
+            }
+            std::vector<SliceCursor<T> > slices;
+            for (long long start = 0; start < len; start += runLength) {
+                SliceCursor<T> slice = { buffer.data() + start,
+                                         buffer.data() + std::min(len, start + runLength) };
+                slices.push_back(slice);
+            }
+            LoserTree<SliceCursor<T>, Less> tree(slices, static_cast<int>(slices.size()), less);
+            while (!slices[tree.winner()].exhausted()) {
+                out.write(slices[tree.winner()].pos++, 1);
+                tree.replay();
+            }
+            return;
+        }
+        if (!runs.is_open()) {
+            runs.open(binaryFile, std::ios::binary | std::ios::trunc);
+        }
+        runs.write(reinterpret_cast<char*>(buffer.data()), len * sizeof(T));
+        totalNumbers += len;
+
+        if (!more) {
+            break;
+        }
+        buffer[0] = extra;
+        len = 1;
+    }
+    runs.close();
+    countRunIO(config, 0, totalNumbers * sizeof(T));
+
+    // Fase 2: mezclar hasta que queden fanIn corridas o menos y formatear la última mezcla
+    long long mergedLength = runLength;
+    std::string source = mergeUntil<T>(binaryFile, totalNumbers, mergedLength,
+                                       (totalNumbers + fanIn - 1) / fanIn, config, less);
+    {
+        TextWriter out(outputFile);
+        mergePass<T>(source, out, totalNumbers, mergedLength, config, less);
+    }
+    countRunIO(config, totalNumbers * sizeof(T), 0);
+    std::remove(source.c_str());
+}
+
+
+int ioFrames(const PagingConfig& config) {
+    /**
+     * ioFrames calcula cuántos marcos del presupuesto se reservan como búferes de lectura
+     * adelantada y escritura en segundo plano; PagedArray usa el resto.
+     *
+     * @param PagingConfig& config
+     * @return readAhead + 1 con el backend stream asíncrono, 0 en otro caso
+    */
+    if (config.backend == "stream" && config.readAhead > 0) {
+        return config.readAhead + 1;
+    }
+    return 0;
+}
+
+
+int sortFrames(const std::string& algorithm) {
+    /**
+     * sortFrames calcula cuántos marcos necesita algorithm además de los de E/S. PagedArray
+     * necesita 2; QS le deja uno al arreglo y usa PARTITION_FRAMES para los bloques de
+     * partition.
+     *
+     * @param String& algorithm
+     * @return 1 + PARTITION_FRAMES con QS, 2 en otro caso
+    */
+    return algorithm == "QS" ? 1 + PARTITION_FRAMES : 2;
+}
+
+
+static int sortedElementSize(const ElementType& element) {
+    // Los registros se ordenan como etiquetas Tagged: todas ocupan 16 bytes
+    return element.kind == ElementType::REC ? static_cast<int>(sizeof(Tagged<unsigned long long>))
+                                 : element.size;
+}
+
+
+PagingStats replayTrace(const std::string& traceFile, const PagingConfig& config) {
+    /**
+     * replayTrace vuelve a pasar una traza de accesos (líneas "R índice" o "W índice", como
+     * las que anota PagedArray con PagingConfig::trace) por la tabla de páginas y la política
+     * de config, sin tocar ningún archivo de datos. Sirve para probar otros tamaños de página,
+     * marcos o políticas sobre el mismo patrón de accesos. Los bytes se cuentan con páginas
+     * completas y los tiempos quedan en 0.
+     *
+     * @param String& traceFile, PagingConfig& config
+     * @return las estadísticas que habría tenido PagedArray con esa configuración
+    */
+    PagingStats stats;
+    const int frames = config.frames - ioFrames(config);
+    // Mismos elementos por página que el PagedArray que anotó la traza
+    const int elementSize = sortedElementSize(config.element);
+    const int pageSize = std::max(1, config.pageBytes / elementSize);
+    const long long pageBytes = static_cast<long long>(pageSize) * elementSize;
+    std::unique_ptr<ReplacementPolicy> policy = makeReplacementPolicy(config.policy, frames);
+    if (!policy) {
+        return stats;
+    }
+
+    PageTable pageTable(frames);
+    std::vector<long long> loadedPages(frames, -1);
+    std::vector<bool> dirtyPages(frames, false);
+    // Solo las páginas que fallaron: los índices de la traza pueden pasar de 2^31
+    std::unordered_map<long long, long long> pageFaults;
+    long long maxPage = -1;
+    int usedFrames = 0;
+    long long lastPage = -1;
+    int lastFrame = -1;
+
+    // Mismo recorrido que PagedArray::frameOf
+    std::ifstream in(traceFile);
+    char operation;
+    long long index;
+    while (in >> operation >> index) {
+        long long page = index / pageSize;
+        stats.accesses++;
+        if (page != lastPage) {
+            lastFrame = pageTable.find(page);
+            if (lastFrame != -1) {
+                policy->accessed(lastFrame);
+            } else {
+                stats.misses++;
+                stats.bytesRead += pageBytes;
+                pageFaults[page]++;
+                maxPage = std::max(maxPage, page);
+
+                lastFrame = usedFrames < frames ? usedFrames++ : policy->victim(page);
+                if (loadedPages[lastFrame] != -1) {
+                    if (dirtyPages[lastFrame]) {
+                        stats.dirtyEvictions++;
+                        stats.bytesWritten += pageBytes;
+                    } else {
+                        stats.cleanEvictions++;
+                    }
+                    dirtyPages[lastFrame] = false;
+                    pageTable.erase(loadedPages[lastFrame]);
+                }
+                loadedPages[lastFrame] = page;
+                pageTable.insert(page, lastFrame);
+                policy->loaded(lastFrame, page);
+            }
+            lastPage = page;
+        }
+        if (operation == 'W') {
+            dirtyPages[lastFrame] = true;
+        }
+    }
+
+    // Al final se guardan las páginas sucias que siguen en memoria
+    for (int frame = 0; frame < frames; frame++) {
+        if (dirtyPages[frame]) {
+            stats.bytesWritten += pageBytes;
+        }
+    }
+    stats.hits = stats.accesses - stats.misses;
+    // Las páginas hasta la última que falló y que nunca se cargaron van a la casilla 0
+    addFaultHistogram(stats, pageFaults, maxPage + 1);
+    return stats;
+}
+
+
+void PagingStats::add(const PagingStats& other) {
+    accesses += other.accesses;
+    hits += other.hits;
+    misses += other.misses;
+    cleanEvictions += other.cleanEvictions;
+    dirtyEvictions += other.dirtyEvictions;
+    bytesRead += other.bytesRead;
+    bytesWritten += other.bytesWritten;
+    loadSeconds += other.loadSeconds;
+    saveSeconds += other.saveSeconds;
+    totalSeconds += other.totalSeconds;
+    if (faultHistogram.size() < other.faultHistogram.size()) {
+        faultHistogram.resize(other.faultHistogram.size(), 0);
+    }
+    for (std::size_t k = 0; k < other.faultHistogram.size(); k++) {
+        faultHistogram[k] += other.faultHistogram[k];
+    }
+}
+
+
+void printStats(std::ostream& out, const PagingStats& stats, const std::string& format) {
+    /**
+     * printStats imprime las estadísticas como texto para leer o, con format "json", como
+     * un objeto JSON en una sola línea.
+     *
+     * @param std::ostream& out, PagingStats& stats, String& format
+    */
+    if (format == "json") {
+        out << "{\"accesses\":" << stats.accesses
+            << ",\"hits\":" << stats.hits
+            << ",\"misses\":" << stats.misses
+            << ",\"clean_evictions\":" << stats.cleanEvictions
+            << ",\"dirty_evictions\":" << stats.dirtyEvictions
+            << ",\"bytes_read\":" << stats.bytesRead
+            << ",\"bytes_written\":" << stats.bytesWritten
+            << ",\"load_seconds\":" << stats.loadSeconds
+            << ",\"save_seconds\":" << stats.saveSeconds
+            << ",\"total_seconds\":" << stats.totalSeconds
+            << ",\"fault_histogram\":[";
+        for (std::size_t k = 0; k < stats.faultHistogram.size(); k++) {
+            out << (k ? "," : "") << stats.faultHistogram[k];
+        }
+        out << "]}\n";
+        return;
+    }
+
+    double hitRate = stats.accesses ? 100.0 * stats.hits / stats.accesses : 0;
+    out << "Accesos:             " << stats.accesses << "\n"
+        << "Aciertos:            " << stats.hits << " (" << hitRate << "%)\n"
+        << "Fallos de página:    " << stats.misses << "\n"
+        << "Reemplazos limpios:  " << stats.cleanEvictions << "\n"
+        << "Reemplazos sucios:   " << stats.dirtyEvictions << "\n"
+        << "Bytes leídos:        " << stats.bytesRead << "\n"
+        << "Bytes escritos:      " << stats.bytesWritten << "\n"
+        << "Tiempo en fallos:    " << stats.loadSeconds << " s\n"
+        << "Tiempo guardando:    " << stats.saveSeconds << " s\n"
+        << "Tiempo total:        " << stats.totalSeconds << " s\n";
+    if (!stats.faultHistogram.empty()) {
+        out << "Fallos por página:\n";
+        for (std::size_t k = 0; k < stats.faultHistogram.size(); k++) {
+            long long low = k ? 1LL << (k - 1) : 0;
+            long long high = k ? (1LL << k) - 1 : 0;
+            out << "  " << low;
+            if (high > low) {
+                out << "-" << high;
+            }
+            out << ": " << stats.faultHistogram[k] << " páginas\n";
+        }
+    }
+}
+
+
+template <class T, int PageSize, class Less>
+static bool sortRange(const std::string& binaryFile, const std::string& algorithm,
+                      const PagingConfig& config, long long first, long long count, Less less) {
+    /**
+     * sortRange corre uno de los algoritmos que pasan por PagedArray sobre los count
+     * elementos de binaryFile que empiezan en first.
+     *
+     * @param String& binaryFile, String& algorithm, PagingConfig& config, long long first,
+     * long long count, Less less
+     * @return false si el algoritmo no se reconoce
+    */
+    // Los bloques de partition de quickSort salen del mismo presupuesto de marcos
+    PagingConfig paged = config;
+    if (algorithm == "QS") {
+        paged.frames -= PARTITION_FRAMES;
+    }
+    PagedArray<T, PageSize> array(binaryFile, paged, first, count);
+    long long totalNumbers = array.size();
 
     // Algoritmos de ordenamiento...
     if (algorithm == "QS") {
-        quickSort(array, 0, totalNumbers - 1);
-        array.writeToFile(totalNumbers);
+        quickSort(array, 0, totalNumbers - 1, less);
     } else if (algorithm == "IS") {
-        insertionSort(array, totalNumbers);
-        array.writeToFile(totalNumbers);
+        insertionSort(array, totalNumbers, less);
     } else if (algorithm == "SS") {
-        selectionSort(array, totalNumbers);
-        array.writeToFile(totalNumbers);
+        selectionSort(array, totalNumbers, less);
     } else if (algorithm == "PS") {
-        bubbleSort(array, totalNumbers);
-        array.writeToFile(totalNumbers);
+        bubbleSort(array, totalNumbers, less);
     } else {
-        std::cerr << "Algoritmo no reconocido: " << algorithm << "\n";
-        return EXIT_FAILURE;
+        return false;
     }
+    array.writeToFile();
+    return true;
+}
 
-    // Convertir el archivo binario de salida a texto
-    convertToText(binaryFile, outputFile);
+
+template <class T, int PageSize, class Less>
+static bool sortPaged(const std::string& binaryFile, const std::string& algorithm,
+                      const PagingConfig& config, Less less) {
+    /**
+     * sortPaged corre uno de los algoritmos que pasan por PagedArray con el tamaño de página
+     * PageSize fijo en compilación (0 si solo se conoce en tiempo de ejecución). Con varios
+     * hilos el archivo se parte en rangos alineados a página; cada hilo ordena el suyo con
+     * su parte de los marcos y al final los rangos se mezclan como corridas del merge sort.
+     *
+     * @param String& binaryFile, String& algorithm, PagingConfig& config, Less less
+     * @return false si el algoritmo no se reconoce
+    */
+    const int threads = workerThreads(config, sortFrames(algorithm));
+    if (threads == 1) {
+        return sortRange<T, PageSize>(binaryFile, algorithm, config, 0, -1, less);
+    }
+
+    const long long totalNumbers = elementsInFile<T>(binaryFile);
+    const int pageSize = pageElements<T>(config);
+    const long long perThread = (totalNumbers + threads - 1) / threads;
+    const long long rangeLength = std::max(1LL, (perThread + pageSize - 1) / pageSize) * pageSize;
+    const int ranges = static_cast<int>((totalNumbers + rangeLength - 1) / rangeLength);
+
+    PagingConfig worker = config;
+    worker.frames = config.frames / threads;
+    std::vector<char> sorted(ranges, false);
+    parallelFor(ranges, [&](int i) {
+        long long first = i * rangeLength;
+        long long count = std::min(rangeLength, totalNumbers - first);
+        // Cada rango anota sus accesos en su propia traza, con índices relativos al rango
+        PagingConfig range = worker;
+        if (!config.trace.empty()) {
+            range.trace = config.trace + "." + std::to_string(i);
+        }
+        sorted[i] = sortRange<T, PageSize>(binaryFile, algorithm, range, first, count, less);
+    });
+    if (std::find(sorted.begin(), sorted.end(), false) != sorted.end()) {
+        return false;
+    }
+
+    // Los hilos ya soltaron sus marcos: la mezcla usa el presupuesto completo
+    mergeSortedRuns<T>(binaryFile, totalNumbers, rangeLength, config, less);
+    return true;
+}
+
+
+template <class T>
+static bool sortTyped(const std::string& binaryFile, const std::string& algorithm,
+                      const PagingConfig& config) {
+    /**
+     * sortTyped ordena un archivo binario de elementos de tipo T. Cada tipo instancia su
+     * propia copia de los algoritmos, con el comparador y la copia de elementos en línea.
+     *
+     * @param String& binaryFile, String& algorithm, PagingConfig& config
+     * @return false si el algoritmo no se reconoce
+    */
+    ElementOrder<T> less;
+    if (algorithm == "MS") {
+        externalMergeSort<T>(binaryFile, config, less);
+        return true;
+    }
+    if (algorithm == "RS") {
+        radixSort<T>(binaryFile, config);
+        return true;
+    }
+
+    // Los tamaños de página más comunes se especializan para evitar la división en cada acceso
+    switch (config.pageBytes) {
+    case 1024:
+        return sortPaged<T, 1024 / sizeof(T)>(binaryFile, algorithm, config, less);
+    case 4096:
+        return sortPaged<T, 4096 / sizeof(T)>(binaryFile, algorithm, config, less);
+    case 16384:
+        return sortPaged<T, 16384 / sizeof(T)>(binaryFile, algorithm, config, less);
+    case 65536:
+        return sortPaged<T, 65536 / sizeof(T)>(binaryFile, algorithm, config, less);
+    default:
+        return sortPaged<T, 0>(binaryFile, algorithm, config, less);
+    }
+}
+
+
+template <class Key>
+static bool sortRecords(const std::string& binaryFile, const std::string& algorithm,
+                        const PagingConfig& config) {
+    /**
+     * sortRecords ordena un archivo de registros de config.element.size bytes por la clave de
+     * tipo Key que está en config.element.keyOffset. Mover registros grandes en cada
+     * intercambio sería caro, así que primero se arma un archivo de etiquetas Tagged (clave y
+     * posición), se ordena con el algoritmo pedido y al final se recorren las etiquetas en
+     * orden copiando cada registro a su lugar a través de un PagedArray de bytes. Los
+     * registros con la misma clave conservan su orden. Si el archivo no tiene una cantidad
+     * entera de registros, los bytes que sobran quedan al final.
+     *
+     * @param String& binaryFile, String& algorithm, PagingConfig& config
+     * @return false si el algoritmo no se reconoce
+    */
+    typedef Tagged<Key> Tag;
+    const int recordSize = config.element.size;
+    const int keyOffset = config.element.keyOffset;
+    const long long totalBytes = fileBytes(binaryFile);
+    const long long records = totalBytes / recordSize;
+    const int perPage = std::max(1, config.pageBytes / recordSize);
+    const int tagsPerPage = pageElements<Tag>(config);
+    const std::string tagsFile = binaryFile + ".tags";
+    const std::string sortedFile = binaryFile + ".sorted";
+
+    // Fase 1: sacar la clave de cada registro, una página de registros a la vez
+    {
+        std::ifstream in(binaryFile, std::ios::binary);
+        std::ofstream out(tagsFile, std::ios::binary | std::ios::trunc);
+        std::vector<char> page(static_cast<std::size_t>(perPage) * recordSize);
+        std::vector<Tag> tags(perPage);
+        for (long long start = 0; start < records; start += perPage) {
+            int len = static_cast<int>(std::min<long long>(perPage, records - start));
+            in.read(page.data(), static_cast<long long>(len) * recordSize);
+            for (int k = 0; k < len; k++) {
+                // Inicializada en cero para que el relleno de la estructura no cambie
+                Tag tag = Tag();
+                std::memcpy(&tag.key, &page[static_cast<std::size_t>(k) * recordSize + keyOffset],
+                            sizeof(Key));
+                tag.index = start + k;
+                tags[k] = tag;
+            }
+            out.write(reinterpret_cast<char*>(tags.data()), len * sizeof(Tag));
+        }
+        countRunIO(config, records * recordSize, records * sizeof(Tag));
     }
 
-    // Eliminar el archivo binario temporal
+    // Fase 2: ordenar las etiquetas
+    if (!sortTyped<Tag>(tagsFile, algorithm, config)) {
+        std::remove(tagsFile.c_str());
+        return false;
+    }
+
+    // Fase 3: copiar los registros en el orden de las etiquetas. Las etiquetas y la salida
+    // se recorren en secuencia con un marco cada una; los registros se leen al azar con el
+    // resto de los marcos (al menos uno, porque hay al menos 3). Leer por adelantado no
+    // sirve para lecturas al azar, así que no se le reservan marcos y el total no pasa de
+    // config.frames
+    {
+        PagingConfig gather = config;
+        gather.frames = config.frames - 2;
+        gather.readAhead = 0;
+        gather.threads = 1;
+        gather.trace.clear();
+        PagedArray<unsigned char> source(binaryFile, gather);
+        std::ifstream in(tagsFile, std::ios::binary);
+        std::ofstream out(sortedFile, std::ios::binary | std::ios::trunc);
+        std::vector<Tag> tags(tagsPerPage);
+        std::vector<unsigned char> page(static_cast<std::size_t>(perPage) * recordSize);
+        int filled = 0;
+        for (long long start = 0; start < records; start += tagsPerPage) {
+            int len = static_cast<int>(std::min<long long>(tagsPerPage, records - start));
+            in.read(reinterpret_cast<char*>(tags.data()), len * sizeof(Tag));
+            for (int k = 0; k < len; k++) {
+                copyOut(source, static_cast<long long>(tags[k].index) * recordSize, recordSize,
+                        &page[static_cast<std::size_t>(filled) * recordSize]);
+                if (++filled == perPage) {
+                    out.write(reinterpret_cast<char*>(page.data()),
+                              static_cast<long long>(filled) * recordSize);
+                    filled = 0;
+                }
+            }
+        }
+        out.write(reinterpret_cast<char*>(page.data()),
+                  static_cast<long long>(filled) * recordSize);
+
+        int rest = static_cast<int>(totalBytes - records * recordSize);
+        copyOut(source, records * recordSize, rest, page.data());
+        out.write(reinterpret_cast<char*>(page.data()), rest);
+        countRunIO(config, records * sizeof(Tag), totalBytes);
+    }
+
+    std::remove(tagsFile.c_str());
     std::remove(binaryFile.c_str());
+    std::rename(sortedFile.c_str(), binaryFile.c_str());
+    return true;
+}
 
 
-    std::cout << "Archivo " << inputFile << " ordenado usando " << algorithm 
-              << " y guardado en " << outputFile << ".\n";
+struct SortTyped {
+    typedef bool result_type;
+    const std::string& binaryFile;
+    const std::string& algorithm;
+    const PagingConfig& config;
 
-    return 0;
+    template <class T>
+    bool operator()(TypeTag<T>) const {
+        return sortTyped<T>(binaryFile, algorithm, config);
+    }
+};
+
+
+struct SortRecords {
+    // El tipo es el de la clave de los registros
+    typedef bool result_type;
+    const std::string& binaryFile;
+    const std::string& algorithm;
+    const PagingConfig& config;
+
+    template <class Key>
+    bool operator()(TypeTag<Key>) const {
+        return sortRecords<Key>(binaryFile, algorithm, config);
+    }
+};
 
-    
 
+struct MergeSortText {
+    typedef void result_type;
+    const std::string& inputFile;
+    const std::string& outputFile;
+    const std::string& binaryFile;
+    const PagingConfig& config;
+
+    template <class T>
+    void operator()(TypeTag<T>) const {
+        mergeSortText<T>(inputFile, outputFile, binaryFile, config, ElementOrder<T>());
+    }
+};
+
+
+bool sortBinaryFile(const std::string& binaryFile, const std::string& algorithm,
+                    const PagingConfig& config) {
+    /**
+     * sortBinaryFile ordena el archivo binario con el algoritmo indicado, usando el tipo de
+     * elemento, el tamaño de página, la cantidad de marcos y la política de reemplazo de
+     * config.
+     *
+     * @param String& binaryFile, String& algorithm, PagingConfig& config
+     * @return false si el algoritmo no se reconoce
+    */
+    const ElementType& element = config.element;
+    if (element.kind == ElementType::REC) {
+        SortRecords sort = { binaryFile, algorithm, config };
+        return dispatchElement(element.key, sort);
+    }
+    SortTyped sort = { binaryFile, algorithm, config };
+    return dispatchElement(element.kind, sort);
 }
 
+
+bool sortTextFile(const std::string& inputFile, const std::string& outputFile,
+                  const std::string& binaryFile, const std::string& algorithm,
+                  const PagingConfig& config) {
+    /**
+     * sortTextFile ordena el archivo de texto inputFile y deja el resultado en outputFile.
+     * MS va directo de texto a texto; los demás algoritmos necesitan el archivo binario
+     * binaryFile para paginarlo y lo borran al terminar. Los registros (-t rec) no tienen
+     * formato de texto: inputFile ya es binario y se ordena una copia en outputFile.
+     *
+     * @param String& inputFile, String& outputFile, String& binaryFile, String& algorithm,
+     * PagingConfig& config
+     * @return false si el algoritmo no se reconoce
+    */
+    const ElementType& element = config.element;
+    if (element.kind == ElementType::REC) {
+        {
+            std::ifstream in(inputFile, std::ios::binary);
+            std::ofstream out(outputFile, std::ios::binary | std::ios::trunc);
+            out << in.rdbuf();
+        }
+        if (!sortBinaryFile(outputFile, algorithm, config)) {
+            std::remove(outputFile.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    if (algorithm == "MS") {
+        MergeSortText sort = { inputFile, outputFile, binaryFile, config };
+        dispatchElement(element.kind, sort);
+        return true;
+    }
+
+    // Convertir el archivo de entrada a binario
+    convertToBinary(inputFile, binaryFile, element);
+
+    if (!sortBinaryFile(binaryFile, algorithm, config)) {
+        std::remove(binaryFile.c_str());
+        return false;
+    }
+
+    // Convertir el archivo binario de salida a texto
+    convertToText(binaryFile, outputFile, element);
+    std::remove(binaryFile.c_str());
+    return true;
+}
+
+
+bool parseSize(const std::string& text, long long& value) {
+    /**
+     * parseSize interpreta un tamaño en bytes que puede terminar en K, M o G.
+     *
+     * @param String& text, long long& value
+     * @return false si el texto no es un tamaño válido
+    */
+    std::size_t used = 0;
+    try {
+        value = std::stoll(text, &used);
+    } catch (...) {
+        return false;
+    }
+    std::string suffix = text.substr(used);
+    if (suffix == "K" || suffix == "k") {
+        value <<= 10;
+    } else if (suffix == "M" || suffix == "m") {
+        value <<= 20;
+    } else if (suffix == "G" || suffix == "g") {
+        value <<= 30;
+    } else if (!suffix.empty()) {
+        return false;
+    }
+    return value > 0;
+}
+
+
+static bool parseKind(const std::string& text, ElementType::Kind& kind) {
+    // Nombre de -t (o del tipo de la clave de un registro) a ElementType::Kind
+    const char* names[] = { "i32", "i64", "u64", "f64" };
+    const ElementType::Kind kinds[] = { ElementType::I32, ElementType::I64, ElementType::U64,
+                                        ElementType::F64 };
+    for (int k = 0; k < 4; k++) {
+        if (text == names[k]) {
+            kind = kinds[k];
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool parseElementType(const std::string& text, ElementType& element) {
+    /**
+     * parseElementType interpreta el valor de -t: i32, i64, u64, f64 o rec:<bytes>:<offset>
+     * para registros de tamaño fijo con la clave en el byte offset. La clave es un u64 salvo
+     * que se agregue su tipo al final (rec:<bytes>:<offset>:<tipo>) y tiene que caber dentro
+     * del registro.
+     *
+     * @param String& text, ElementType& element
+     * @return false si el texto no es un tipo válido
+    */
+    ElementType parsed;
+    if (parseKind(text, parsed.kind)) {
+        parsed.size = parsed.kind == ElementType::I32 ? 4 : 8;
+    } else if (text.compare(0, 4, "rec:") == 0) {
+        std::istringstream fields(text.substr(4));
+        char colon;
+        long long size, keyOffset;
+        if (!(fields >> size >> colon >> keyOffset) || colon != ':') {
+            return false;
+        }
+        if (fields >> colon) {
+            std::string key;
+            if (colon != ':' || !(fields >> key) || !parseKind(key, parsed.key)) {
+                return false;
+            }
+        }
+        const int keySize = parsed.key == ElementType::I32 ? 4 : 8;
+        if (size <= 0 || size > 1 << 20 || keyOffset < 0 || keyOffset + keySize > size) {
+            return false;
+        }
+        parsed.kind = ElementType::REC;
+        parsed.size = static_cast<int>(size);
+        parsed.keyOffset = static_cast<int>(keyOffset);
+    } else {
+        return false;
+    }
+    element = parsed;
+    return true;
+}
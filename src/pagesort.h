@@ -1,8 +1,86 @@
+#ifndef PAGESORT_H
+#define PAGESORT_H
 
-int findLRUPage();
-void savePageToDisk(int pageIndex);
-void markPageDirty(int index);
-void writeToFile(int totalNumbers);
-void convertToBinary(const std::string& inputFile, const std::string& binaryFile);
-void convertToText(const std::string& binaryFile, const std::string& textFile);
-int getTotalNumbersInFile(const std::string& filename);
\ No newline at end of file
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+const int PAGE_BYTES = 1024;  // bytes por página por defecto
+const int PAGE_FRAMES = 6;  // cantidad de páginas que pueden estar en memoria a la vez por defecto
+const int PARTITION_FRAMES = 2;  // marcos que QS le quita a PagedArray para los bloques de partition
+
+struct PagingStats {
+    /*PagingStats junta los contadores del paginador durante un ordenamiento. Los bytes y
+     * tiempos cuentan la E/S de páginas (y la de las corridas en MS); con varios hilos los
+     * tiempos se suman entre hilos, así que pueden pasar del tiempo total.
+    */
+    long long accesses = 0;        // lecturas y escrituras de elementos
+    long long hits = 0;            // accesos cuya página ya estaba en un marco
+    long long misses = 0;          // fallos de página
+    long long cleanEvictions = 0;  // páginas que salieron de un marco sin cambios
+    long long dirtyEvictions = 0;  // páginas que salieron de un marco y se escribieron
+    long long bytesRead = 0;
+    long long bytesWritten = 0;
+    double loadSeconds = 0;   // atendiendo fallos (incluye escribir la víctima si estaba sucia)
+    double saveSeconds = 0;   // guardando páginas sucias que siguen en memoria
+    double totalSeconds = 0;  // lo mide quien llama; 0 si no se midió
+    // faultHistogram[0] cuenta las páginas sin fallos y faultHistogram[k] las que fallaron
+    // entre 2^(k-1) y 2^k - 1 veces
+    std::vector<long long> faultHistogram;
+
+    void add(const PagingStats& other);
+};
+
+struct ElementType {
+    /*ElementType dice qué hay en el archivo binario (-t): enteros de 32 o 64 bits, enteros
+     * sin signo de 64 bits, double, o registros de tamaño fijo que se ordenan por una clave
+     * que está en una posición fija de cada registro. parseElementType traduce el nombre a
+     * Kind una sola vez.
+    */
+    enum Kind { I32, I64, U64, F64, REC };
+
+    Kind kind = I32;     // i32, i64, u64, f64 o rec
+    int size = 4;        // bytes de cada elemento
+    int keyOffset = 0;   // rec: byte del registro donde empieza la clave
+    Kind key = U64;      // rec: tipo de la clave (I32, I64, U64 o F64)
+};
+
+struct PagingConfig {
+    /*PagingConfig reúne las opciones del paginador que se pueden escoger desde la línea de
+     * comandos. El tamaño de página va en bytes: cada tipo de elemento mete en una página
+     * los que quepan.
+    */
+    int pageBytes = PAGE_BYTES;  // bytes por página
+    int frames = PAGE_FRAMES;    // páginas que pueden estar en memoria a la vez
+    std::string policy = "LRU";  // política de reemplazo
+    std::string backend = "stream";  // cómo se leen y escriben las páginas: stream o mmap
+    int readAhead = 0;  // páginas que se leen por adelantado en recorridos secuenciales
+    int threads = 1;    // hilos que ordenan a la vez; se reparten los marcos entre ellos
+    PagingStats* stats = nullptr;  // si no es nulo, ahí se suman las estadísticas
+    std::string trace;  // si no está vacío, archivo donde se anota cada acceso (ver replayTrace)
+    ElementType element;  // tipo de los elementos del archivo
+};
+
+bool parseElementType(const std::string& text, ElementType& element);
+bool parseSize(const std::string& text, long long& value);
+
+int ioFrames(const PagingConfig& config);
+int sortFrames(const std::string& algorithm);
+PagingStats replayTrace(const std::string& traceFile, const PagingConfig& config);
+void printStats(std::ostream& out, const PagingStats& stats, const std::string& format);
+
+void convertToBinary(const std::string& inputFile, const std::string& binaryFile,
+                     const ElementType& element = ElementType());
+void convertToText(const std::string& binaryFile, const std::string& textFile,
+                   const ElementType& element = ElementType());
+long long fileBytes(const std::string& filename);
+long long getTotalNumbersInFile(const std::string& filename);
+void externalMergeSort(const std::string& binaryFile, const PagingConfig& config = PagingConfig());
+void radixSort(const std::string& binaryFile, const PagingConfig& config = PagingConfig());
+bool sortBinaryFile(const std::string& binaryFile, const std::string& algorithm,
+                    const PagingConfig& config = PagingConfig());
+bool sortTextFile(const std::string& inputFile, const std::string& outputFile,
+                  const std::string& binaryFile, const std::string& algorithm,
+                  const PagingConfig& config = PagingConfig());
+
+#endif
@@ -0,0 +1,393 @@
+#include "pagestore.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PAGESTORE_HAS_POSIX 1
+#endif
+
+
+// ---------------------------------------------------------------- fstream
+
+// Cantidad de elementos del rango: count, o hasta el final del archivo si count es negativo
+static long long rangeLength(long long fileElements, long long first, long long count) {
+    long long available = std::max(0LL, fileElements - first);
+    return count < 0 ? available : std::min(count, available);
+}
+
+// Elementos de la página; la última puede quedar incompleta
+static int pageLength(int pageSize, long long totalNumbers, long long page) {
+    return static_cast<int>(std::min<long long>(pageSize, totalNumbers - page * pageSize));
+}
+
+StreamPageStore::StreamPageStore(const std::string& filename, int elementSize, int pageSize,
+                                 int frames, long long first, long long count)
+    : elementSize(elementSize), pageSize(pageSize), first(first),
+      buffers(frames, std::vector<char>(static_cast<std::size_t>(pageSize) * elementSize, 0)) {
+    file.open(filename, std::ios::in | std::ios::out | std::ios::binary | std::ios::ate);
+    if (file.is_open()) {
+        totalNumbers = rangeLength(static_cast<long long>(file.tellg()) / elementSize, first,
+                                   count);
+    }
+}
+
+bool StreamPageStore::isOpen() const {
+    return file.is_open();
+}
+
+long long StreamPageStore::elements() const {
+    return totalNumbers;
+}
+
+char* StreamPageStore::load(long long page, int frame) {
+    file.seekg((first + page * pageSize) * elementSize, file.beg);
+    std::streamsize length = pageLength(pageSize, totalNumbers, page);
+    file.read(buffers[frame].data(), length * elementSize);
+    return buffers[frame].data();
+}
+
+void StreamPageStore::save(long long page, int frame) {
+    file.seekp((first + page * pageSize) * elementSize, file.beg);
+    std::streamsize length = pageLength(pageSize, totalNumbers, page);
+    file.write(buffers[frame].data(), length * elementSize);
+}
+
+void StreamPageStore::evict(long long page, int frame, bool dirty) {
+    // El búfer del marco se reutiliza tal cual para la siguiente página
+    if (dirty) {
+        save(page, frame);
+    }
+}
+
+
+// ---------------------------------------------------------------- mmap
+
+#ifdef PAGESTORE_HAS_POSIX
+
+MappedPageStore::MappedPageStore(const std::string& filename, int elementSize, int pageSize,
+                                 int frames, int readAhead, long long first, long long count)
+    : elementSize(elementSize), first(first), pageSize(pageSize),
+      systemPage(sysconf(_SC_PAGESIZE)), readAhead(readAhead), mappings(frames, nullptr),
+      mappedBytes(frames, 0) {
+    fd = open(filename.c_str(), O_RDWR);
+    if (fd == -1) {
+        return;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0) {
+        totalNumbers = rangeLength(info.st_size / elementSize, first, count);
+    }
+}
+
+MappedPageStore::~MappedPageStore() {
+    for (std::size_t frame = 0; frame < mappings.size(); frame++) {
+        if (mappings[frame]) {
+            munmap(mappings[frame], mappedBytes[frame]);
+        }
+    }
+    if (fd != -1) {
+        close(fd);
+    }
+}
+
+bool MappedPageStore::isOpen() const {
+    return fd != -1;
+}
+
+long long MappedPageStore::elements() const {
+    return totalNumbers;
+}
+
+char* MappedPageStore::load(long long page, int frame) {
+    // Posiciones en bytes dentro del archivo; el mapeo tiene que empezar en una página del
+    // sistema
+    const long long pageBytes = static_cast<long long>(pageSize) * elementSize;
+    long long rangeEnd = (first + totalNumbers) * elementSize;
+    long long start = (first + page * pageSize) * elementSize;
+    long long end = std::min(start + pageBytes, rangeEnd);
+    long long alignedStart = start / systemPage * systemPage;
+    if (mappings[frame]) {
+        munmap(mappings[frame], mappedBytes[frame]);
+    }
+    void* mapping = mmap(nullptr, end - alignedStart, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                         alignedStart);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "No se pudo mapear la página " << page << " del archivo" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    mappings[frame] = static_cast<char*>(mapping);
+    mappedBytes[frame] = end - alignedStart;
+    madvise(mapping, end - alignedStart, MADV_WILLNEED);
+    if (page == lastMiss + 1 && readAhead > 0 && end < rangeEnd) {
+        // Fallos en secuencia: que el kernel lea también las páginas siguientes a su caché
+        posix_fadvise(fd, end, std::min(readAhead * pageBytes, rangeEnd - end),
+                      POSIX_FADV_WILLNEED);
+    }
+    lastMiss = page;
+    return mappings[frame] + (start - alignedStart);
+}
+
+void MappedPageStore::save(long long, int) {
+    // Las escrituras ya están en el mapeo compartido; el kernel las lleva al archivo
+}
+
+void MappedPageStore::evict(long long, int frame, bool) {
+    // Desmapear suelta las páginas del proceso; las escritas siguen en la caché del sistema
+    munmap(mappings[frame], mappedBytes[frame]);
+    mappings[frame] = nullptr;
+}
+
+
+// ---------------------------------------------------------------- pread/pwrite asíncrono
+
+AsyncPageStore::AsyncPageStore(const std::string& filename, int elementSize, int pageSize,
+                               int frames, int readAhead, long long first, long long count)
+    : elementSize(elementSize), pageSize(pageSize), first(first), readAhead(readAhead),
+      buffers(frames + readAhead + 1,
+              std::vector<char>(static_cast<std::size_t>(pageSize) * elementSize, 0)),
+      busy(buffers.size(), false), frameBuffer(frames), bufferPage(buffers.size(), -1) {
+    fd = open(filename.c_str(), O_RDWR);
+    if (fd == -1) {
+        return;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0) {
+        totalNumbers = rangeLength(info.st_size / elementSize, first, count);
+    }
+    for (int frame = 0; frame < frames; frame++) {
+        frameBuffer[frame] = frame;
+    }
+    for (int buffer = frames; buffer < static_cast<int>(buffers.size()); buffer++) {
+        freeBuffers.push_back(buffer);
+    }
+    worker = std::thread(&AsyncPageStore::run, this);
+}
+
+AsyncPageStore::~AsyncPageStore() {
+    if (worker.joinable()) {
+        // El hilo termina los trabajos pendientes antes de salir
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+    if (fd != -1) {
+        close(fd);
+    }
+}
+
+bool AsyncPageStore::isOpen() const {
+    return fd != -1;
+}
+
+long long AsyncPageStore::elements() const {
+    return totalNumbers;
+}
+
+void AsyncPageStore::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty()) {
+            return;
+        }
+        Job job = jobs.front();
+        jobs.pop_front();
+        lock.unlock();
+
+        char* data = buffers[job.buffer].data();
+        size_t length =
+            static_cast<size_t>(pageLength(pageSize, totalNumbers, job.page)) * elementSize;
+        off_t offset = (first + static_cast<off_t>(job.page) * pageSize) * elementSize;
+        size_t done = 0;
+        while (done < length) {
+            ssize_t count = job.write ? pwrite(fd, data + done, length - done, offset + done)
+                                      : pread(fd, data + done, length - done, offset + done);
+            if (count < 0 && errno == EINTR) {
+                continue;  // Una señal cortó la llamada antes de mover nada: se reintenta
+            }
+            if (count <= 0) {
+                // Seguir dejaría en el marco los bytes de otra página, o perdería esta
+                std::cerr << "No se pudo " << (job.write ? "escribir" : "leer") << " la página "
+                          << job.page << " del archivo" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            done += count;
+        }
+
+        lock.lock();
+        busy[job.buffer] = false;
+        finished.notify_all();
+    }
+}
+
+void AsyncPageStore::submit(bool write, long long page, int buffer) {
+    Job job;
+    job.write = write;
+    job.page = page;
+    job.buffer = buffer;
+    busy[buffer] = true;
+    bufferPage[buffer] = page;
+    jobs.push_back(job);
+    wake.notify_one();
+}
+
+void AsyncPageStore::waitFor(std::unique_lock<std::mutex>& lock, int buffer) {
+    finished.wait(lock, [this, buffer] { return !busy[buffer]; });
+}
+
+void AsyncPageStore::dropPrefetch(std::unique_lock<std::mutex>& lock, long long page) {
+    std::unordered_map<long long, int>::iterator it = prefetchOf.find(page);
+    if (it == prefetchOf.end()) {
+        return;
+    }
+    int buffer = it->second;
+    prefetchOf.erase(it);
+    prefetched.erase(std::find(prefetched.begin(), prefetched.end(), buffer));
+    waitFor(lock, buffer);
+    freeBuffers.push_back(buffer);
+}
+
+int AsyncPageStore::takeBuffer(std::unique_lock<std::mutex>& lock, bool wait) {
+    /**
+     * takeBuffer consigue un búfer libre. Primero recupera los que ya terminaron de
+     * escribirse; si wait es verdadero y no hay ninguno, descarta la página adelantada más
+     * vieja o espera a que termine una escritura.
+     *
+     * @param unique_lock& lock, bool wait
+     * @return el búfer, o -1 si no hay ninguno libre y wait es falso
+    */
+    for (;;) {
+        while (!writing.empty() && !busy[writing.front()]) {
+            freeBuffers.push_back(writing.front());
+            writing.pop_front();
+        }
+        if (!freeBuffers.empty()) {
+            int buffer = freeBuffers.back();
+            freeBuffers.pop_back();
+            return buffer;
+        }
+        if (!wait) {
+            return -1;
+        }
+        if (!prefetched.empty()) {
+            dropPrefetch(lock, bufferPage[prefetched.front()]);
+        } else {
+            waitFor(lock, writing.front());
+        }
+    }
+}
+
+char* AsyncPageStore::load(long long page, int frame) {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    std::unordered_map<long long, int>::iterator it = prefetchOf.find(page);
+    if (it != prefetchOf.end()) {
+        // Ya se pidió por adelantado: cambiar el búfer del marco por el de la página
+        int buffer = it->second;
+        prefetchOf.erase(it);
+        prefetched.erase(std::find(prefetched.begin(), prefetched.end(), buffer));
+        waitFor(lock, buffer);
+        freeBuffers.push_back(frameBuffer[frame]);
+        frameBuffer[frame] = buffer;
+    } else {
+        submit(false, page, frameBuffer[frame]);
+        waitFor(lock, frameBuffer[frame]);
+    }
+
+    if (page == lastMiss + 1) {
+        const long long pages = (totalNumbers + pageSize - 1) / pageSize;
+        for (long long next = page + 1; next <= page + readAhead && next < pages; next++) {
+            if (prefetchOf.count(next)) {
+                continue;
+            }
+            int buffer = takeBuffer(lock, false);
+            if (buffer == -1) {
+                break;
+            }
+            submit(false, next, buffer);
+            prefetchOf[next] = buffer;
+            prefetched.push_back(buffer);
+        }
+    }
+    lastMiss = page;
+
+    return buffers[frameBuffer[frame]].data();
+}
+
+void AsyncPageStore::save(long long page, int frame) {
+    // La página sigue en el marco, así que aquí sí hay que esperar a que se escriba
+    std::unique_lock<std::mutex> lock(mutex);
+    dropPrefetch(lock, page);
+    submit(true, page, frameBuffer[frame]);
+    waitFor(lock, frameBuffer[frame]);
+}
+
+void AsyncPageStore::evict(long long page, int frame, bool dirty) {
+    if (!dirty) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    dropPrefetch(lock, page);
+    int buffer = takeBuffer(lock, true);
+    submit(true, page, frameBuffer[frame]);
+    writing.push_back(frameBuffer[frame]);
+    frameBuffer[frame] = buffer;
+}
+
+#endif
+
+
+long long systemPageBytes() {
+    /**
+     * systemPageBytes devuelve el tamaño de la página del sistema, la unidad con la que
+     * MappedPageStore mapea y suelta memoria.
+     *
+     * @return bytes por página del sistema (4096 si no se puede consultar)
+    */
+#ifdef PAGESTORE_HAS_POSIX
+    return sysconf(_SC_PAGESIZE);
+#else
+    return 4096;
+#endif
+}
+
+
+std::unique_ptr<PageStore> makePageStore(const std::string& backend, const std::string& filename,
+                                         int elementSize, int pageSize, int frames,
+                                         int readAhead, long long first, long long count) {
+    /**
+     * makePageStore abre el archivo con el backend indicado, o solo el rango de count
+     * elementos de elementSize bytes que empieza en first (count negativo: hasta el final
+     * del archivo).
+     *
+     * @param String& backend, String& filename, int elementSize, int pageSize, int frames,
+     * int readAhead, long long first, long long count
+     * @return el PageStore, o nullptr si el backend no es stream ni mmap (o mmap no está
+     * disponible en esta plataforma)
+    */
+#ifdef PAGESTORE_HAS_POSIX
+    if (backend == "stream" && readAhead > 0) {
+        return std::unique_ptr<PageStore>(
+            new AsyncPageStore(filename, elementSize, pageSize, frames, readAhead, first, count));
+    }
+    if (backend == "mmap") {
+        return std::unique_ptr<PageStore>(
+            new MappedPageStore(filename, elementSize, pageSize, frames, readAhead, first,
+                                count));
+    }
+#endif
+    if (backend == "stream") {
+        return std::unique_ptr<PageStore>(
+            new StreamPageStore(filename, elementSize, pageSize, frames, first, count));
+    }
+    return std::unique_ptr<PageStore>();
+}
@@ -0,0 +1,158 @@
+#ifndef PAGESTORE_H
+#define PAGESTORE_H
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+class PageStore {
+    /*PageStore es de donde PagedArray trae las páginas y a donde las devuelve. load deja la
+     * página en el marco indicado y devuelve dónde quedaron sus bytes, save guarda en el
+     * archivo lo que tiene el marco y evict avisa que la página sale del marco (si dirty es
+     * verdadero, su contenido tiene que llegar al archivo).
+     *
+     * No sabe de tipos: una página son pageSize elementos de elementSize bytes cada uno, y
+     * PagedArray interpreta los bytes. Un PageStore puede abrir solo un rango del archivo
+     * (count elementos a partir de first); las páginas se cuentan desde el inicio del rango.
+     * Así varios hilos ordenan partes distintas del mismo archivo, cada uno con su propio
+     * PageStore.
+    */
+public:
+    virtual ~PageStore() {}
+    virtual bool isOpen() const = 0;
+    virtual long long elements() const = 0;
+    virtual char* load(long long page, int frame) = 0;
+    virtual void save(long long page, int frame) = 0;
+    virtual void evict(long long page, int frame, bool dirty) = 0;
+};
+
+
+class StreamPageStore : public PageStore {
+    /*StreamPageStore copia cada página entre el archivo y un búfer propio de cada marco con
+     * std::fstream.
+    */
+    std::fstream file;
+    int elementSize;
+    int pageSize;
+    long long first;
+    long long totalNumbers = 0;
+    std::vector<std::vector<char> > buffers;
+
+public:
+    StreamPageStore(const std::string& filename, int elementSize, int pageSize, int frames,
+                    long long first = 0, long long count = -1);
+    bool isOpen() const override;
+    long long elements() const override;
+    char* load(long long page, int frame) override;
+    void save(long long page, int frame) override;
+    void evict(long long page, int frame, bool dirty) override;
+};
+
+
+class MappedPageStore : public PageStore {
+    /*MappedPageStore le da a cada marco su propio mapeo (mmap compartido) de la página que
+     * tiene, sin copias. Cargar una página la mapea y sacarla la desmapea, así el proceso
+     * nunca tiene más memoria del archivo que la de sus marcos: con un solo mapeo del
+     * archivo completo el kernel mapea de una vez las páginas vecinas que ya están en la
+     * caché (fault-around, folios grandes) y madvise(DONTNEED) sobre una página no alcanza
+     * para soltarlas. Como el mapeo es compartido, desmapear no pierde escrituras: quedan en
+     * la caché de páginas del sistema. Cada mapeo empieza en una página del sistema, así que
+     * el tamaño de página conviene que sea múltiplo del de la página del sistema (ver
+     * systemPageBytes).
+    */
+    int fd = -1;
+    int elementSize;
+    long long first;
+    long long totalNumbers = 0;
+    int pageSize;
+    long long systemPage;
+    int readAhead;
+    long long lastMiss = -2;
+    std::vector<char*> mappings;        // mapeo de cada marco, nullptr si está libre
+    std::vector<long long> mappedBytes;  // largo de cada mapeo
+
+public:
+    MappedPageStore(const std::string& filename, int elementSize, int pageSize, int frames,
+                    int readAhead, long long first = 0, long long count = -1);
+    ~MappedPageStore();
+    bool isOpen() const override;
+    long long elements() const override;
+    char* load(long long page, int frame) override;
+    void save(long long page, int frame) override;
+    void evict(long long page, int frame, bool dirty) override;
+};
+
+
+class AsyncPageStore : public PageStore {
+    /*AsyncPageStore hace la E/S en un hilo aparte con pread/pwrite. Cuando los fallos de
+     * página van en secuencia (p, p + 1, ...) pide por adelantado las readAhead páginas
+     * siguientes, y las páginas sucias que salen de un marco se escriben en segundo plano:
+     * el marco recibe un búfer libre y el viejo se entrega al hilo. Los búferes extra
+     * (readAhead + 1) salen del mismo presupuesto de marcos, ver ioFrames.
+     *
+     * El hilo atiende los trabajos en orden, así una lectura de una página siempre ve la
+     * escritura que se pidió antes. Guardar una página descarta la copia adelantada que
+     * hubiera de ella, porque quedó vieja.
+    */
+    struct Job {
+        bool write;
+        long long page;
+        int buffer;
+    };
+
+    int fd = -1;
+    int elementSize;
+    int pageSize;
+    long long first;
+    long long totalNumbers = 0;
+    int readAhead;
+    long long lastMiss = -2;
+
+    std::vector<std::vector<char> > buffers;
+    std::vector<bool> busy;                   // hay un trabajo pendiente sobre el búfer
+    std::vector<int> frameBuffer;             // búfer que usa cada marco
+    std::vector<int> freeBuffers;
+    std::deque<int> prefetched;               // búferes con páginas adelantadas, el más viejo primero
+    std::unordered_map<long long, int> prefetchOf;  // página adelantada -> búfer
+    std::vector<long long> bufferPage;
+    std::deque<int> writing;                  // búferes que se están escribiendo
+
+    std::deque<Job> jobs;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::thread worker;
+    bool stopping = false;
+
+    void run();
+    void submit(bool write, long long page, int buffer);
+    void waitFor(std::unique_lock<std::mutex>& lock, int buffer);
+    void dropPrefetch(std::unique_lock<std::mutex>& lock, long long page);
+    int takeBuffer(std::unique_lock<std::mutex>& lock, bool wait);
+
+public:
+    AsyncPageStore(const std::string& filename, int elementSize, int pageSize, int frames,
+                   int readAhead, long long first = 0, long long count = -1);
+    ~AsyncPageStore();
+    bool isOpen() const override;
+    long long elements() const override;
+    char* load(long long page, int frame) override;
+    void save(long long page, int frame) override;
+    void evict(long long page, int frame, bool dirty) override;
+};
+
+
+long long systemPageBytes();
+std::unique_ptr<PageStore> makePageStore(const std::string& backend, const std::string& filename,
+                                         int elementSize, int pageSize, int frames,
+                                         int readAhead = 0, long long first = 0,
+                                         long long count = -1);
+
+#endif
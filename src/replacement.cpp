@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <iterator>
+#include "replacement.h"
+
+
+// ---------------------------------------------------------------- LRU
+
+LRUPolicy::LRUPolicy(int frames) : prev(frames, -1), next(frames, -1) {}
+
+void LRUPolicy::unlink(int frame) {
+    if (prev[frame] != -1) {
+        next[prev[frame]] = next[frame];
+    } else {
+        head = next[frame];
+    }
+    if (next[frame] != -1) {
+        prev[next[frame]] = prev[frame];
+    } else {
+        tail = prev[frame];
+    }
+    prev[frame] = next[frame] = -1;
+}
+
+void LRUPolicy::pushFront(int frame) {
+    prev[frame] = -1;
+    next[frame] = head;
+    if (head != -1) {
+        prev[head] = frame;
+    }
+    head = frame;
+    if (tail == -1) {
+        tail = frame;
+    }
+}
+
+void LRUPolicy::accessed(int frame) {
+    if (head != frame) {
+        unlink(frame);
+        pushFront(frame);
+    }
+}
+
+void LRUPolicy::loaded(int frame, long long /*page*/) {
+    pushFront(frame);
+}
+
+int LRUPolicy::victim(long long /*page*/) {
+    int frame = tail;
+    unlink(frame);
+    return frame;
+}
+
+
+// ---------------------------------------------------------------- CLOCK
+
+ClockPolicy::ClockPolicy(int frames) : referenced(frames, false) {}
+
+void ClockPolicy::accessed(int frame) {
+    referenced[frame] = true;
+}
+
+void ClockPolicy::loaded(int frame, long long /*page*/) {
+    referenced[frame] = true;
+}
+
+int ClockPolicy::victim(long long /*page*/) {
+    const int frames = static_cast<int>(referenced.size());
+    while (referenced[hand]) {
+        referenced[hand] = false;
+        hand = (hand + 1) % frames;
+    }
+    int frame = hand;
+    hand = (hand + 1) % frames;
+    return frame;
+}
+
+
+// ---------------------------------------------------------------- LFU
+
+LFUPolicy::LFUPolicy(int frames) : bucketOf(frames), position(frames) {}
+
+void LFUPolicy::accessed(int frame) {
+    std::list<Bucket>::iterator current = bucketOf[frame];
+    std::list<Bucket>::iterator following = std::next(current);
+    if (following == buckets.end() || following->count != current->count + 1) {
+        Bucket bucket;
+        bucket.count = current->count + 1;
+        following = buckets.insert(following, bucket);
+    }
+    // splice mueve el nodo sin reservar memoria y mantiene válido el iterador
+    following->frames.splice(following->frames.begin(), current->frames, position[frame]);
+    bucketOf[frame] = following;
+    if (current->frames.empty()) {
+        buckets.erase(current);
+    }
+}
+
+void LFUPolicy::loaded(int frame, long long /*page*/) {
+    if (buckets.empty() || buckets.front().count != 1) {
+        Bucket bucket;
+        bucket.count = 1;
+        buckets.push_front(bucket);
+    }
+    buckets.front().frames.push_front(frame);
+    bucketOf[frame] = buckets.begin();
+    position[frame] = buckets.front().frames.begin();
+}
+
+int LFUPolicy::victim(long long /*page*/) {
+    Bucket& least = buckets.front();
+    int frame = least.frames.back();
+    least.frames.pop_back();
+    if (least.frames.empty()) {
+        buckets.pop_front();
+    }
+    return frame;
+}
+
+
+// ---------------------------------------------------------------- ARC
+
+ARCPolicy::ARCPolicy(int frames)
+    : capacity(frames), frameList(frames, T1), framePosition(frames), framePage(frames, -1) {}
+
+void ARCPolicy::forgetGhost(ListId list) {
+    ghosts.erase(lists[list].back());
+    lists[list].pop_back();
+}
+
+int ARCPolicy::replace(bool hitInB2) {
+    const int t1 = static_cast<int>(lists[T1].size());
+    ListId from = T2;
+    if (t1 > 0 && (t1 > target || (hitInB2 && t1 == target) || lists[T2].empty())) {
+        from = T1;
+    }
+    ListId ghost = from == T1 ? B1 : B2;
+
+    int frame = static_cast<int>(lists[from].back());
+    lists[from].pop_back();
+    lists[ghost].push_front(framePage[frame]);
+    ghosts[framePage[frame]] = std::make_pair(ghost, lists[ghost].begin());
+    return frame;
+}
+
+void ARCPolicy::accessed(int frame) {
+    lists[T2].splice(lists[T2].begin(), lists[frameList[frame]], framePosition[frame]);
+    frameList[frame] = T2;
+}
+
+void ARCPolicy::loaded(int frame, long long page) {
+    ListId list = T1;
+    GhostMap::iterator ghost = ghosts.find(page);
+    if (ghost != ghosts.end()) {
+        // Ya se había visto: entra directo a T2
+        lists[ghost->second.first].erase(ghost->second.second);
+        ghosts.erase(ghost);
+        list = T2;
+    }
+    lists[list].push_front(frame);
+    frameList[frame] = list;
+    framePosition[frame] = lists[list].begin();
+    framePage[frame] = page;
+}
+
+int ARCPolicy::victim(long long page) {
+    const int b1 = static_cast<int>(lists[B1].size());
+    const int b2 = static_cast<int>(lists[B2].size());
+    GhostMap::iterator ghost = ghosts.find(page);
+
+    if (ghost != ghosts.end() && ghost->second.first == B1) {
+        target = std::min(capacity, target + std::max(b2 / b1, 1));
+        return replace(false);
+    }
+    if (ghost != ghosts.end()) {
+        target = std::max(0, target - std::max(b1 / b2, 1));
+        return replace(true);
+    }
+
+    const int l1 = static_cast<int>(lists[T1].size()) + b1;
+    if (l1 == capacity) {
+        if (static_cast<int>(lists[T1].size()) < capacity) {
+            forgetGhost(B1);
+            return replace(false);
+        }
+        // B1 vacía y T1 llena: la página sale sin dejar rastro
+        int frame = static_cast<int>(lists[T1].back());
+        lists[T1].pop_back();
+        return frame;
+    }
+    if (l1 + static_cast<int>(lists[T2].size()) + b2 >= 2 * capacity && b2 > 0) {
+        forgetGhost(B2);
+    }
+    return replace(false);
+}
+
+
+// ---------------------------------------------------------------- 2Q
+
+TwoQueuePolicy::TwoQueuePolicy(int frames)
+    : inCapacity(std::max(1, frames / 4)), outCapacity(std::max(1, frames / 2)),
+      inAm(frames, false), framePosition(frames), framePage(frames, -1) {}
+
+void TwoQueuePolicy::accessed(int frame) {
+    // Un acierto en A1in no cambia nada: es una cola FIFO
+    if (inAm[frame]) {
+        am.splice(am.begin(), am, framePosition[frame]);
+    }
+}
+
+void TwoQueuePolicy::loaded(int frame, long long page) {
+    std::unordered_map<long long, std::list<long long>::iterator>::iterator ghost =
+        ghosts.find(page);
+    if (ghost != ghosts.end()) {
+        a1out.erase(ghost->second);
+        ghosts.erase(ghost);
+        am.push_front(frame);
+        framePosition[frame] = am.begin();
+        inAm[frame] = true;
+    } else {
+        a1in.push_front(frame);
+        framePosition[frame] = a1in.begin();
+        inAm[frame] = false;
+    }
+    framePage[frame] = page;
+}
+
+int TwoQueuePolicy::victim(long long /*page*/) {
+    int frame;
+    if (am.empty() || static_cast<int>(a1in.size()) > inCapacity) {
+        frame = a1in.back();
+        a1in.pop_back();
+        // Recordar la página expulsada de A1in por si se vuelve a pedir pronto
+        a1out.push_front(framePage[frame]);
+        ghosts[framePage[frame]] = a1out.begin();
+        if (static_cast<int>(a1out.size()) > outCapacity) {
+            ghosts.erase(a1out.back());
+            a1out.pop_back();
+        }
+    } else {
+        frame = am.back();
+        am.pop_back();
+    }
+    return frame;
+}
+
+
+std::unique_ptr<ReplacementPolicy> makeReplacementPolicy(const std::string& name, int frames) {
+    /**
+     * makeReplacementPolicy crea la política de reemplazo con el nombre dado.
+     *
+     * @param String& name, int frames
+     * @return la política, o nullptr si el nombre no es LRU, CLOCK, LFU, ARC ni 2Q
+    */
+    if (name == "LRU") {
+        return std::unique_ptr<ReplacementPolicy>(new LRUPolicy(frames));
+    } else if (name == "CLOCK") {
+        return std::unique_ptr<ReplacementPolicy>(new ClockPolicy(frames));
+    } else if (name == "LFU") {
+        return std::unique_ptr<ReplacementPolicy>(new LFUPolicy(frames));
+    } else if (name == "ARC") {
+        return std::unique_ptr<ReplacementPolicy>(new ARCPolicy(frames));
+    } else if (name == "2Q") {
+        return std::unique_ptr<ReplacementPolicy>(new TwoQueuePolicy(frames));
+    }
+    return std::unique_ptr<ReplacementPolicy>();
+}
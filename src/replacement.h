@@ -0,0 +1,133 @@
+#ifndef REPLACEMENT_H
+#define REPLACEMENT_H
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+class ReplacementPolicy {
+    /*ReplacementPolicy decide qué marco de PagedArray se reemplaza cuando hay un fallo de
+     * página y todos los marcos están ocupados. PagedArray avisa a la política de cada acierto
+     * (accessed) y de cada página cargada (loaded); victim solo se llama con la memoria llena.
+    */
+public:
+    virtual ~ReplacementPolicy() {}
+    virtual void accessed(int frame) = 0;
+    virtual void loaded(int frame, long long page) = 0;
+    virtual int victim(long long page) = 0;
+};
+
+
+class LRUPolicy : public ReplacementPolicy {
+    /*LRU con una lista doblemente enlazada sobre los marcos: el más reciente al frente y el
+     * menos reciente atrás.
+    */
+    std::vector<int> prev, next;
+    int head = -1;
+    int tail = -1;
+
+    void unlink(int frame);
+    void pushFront(int frame);
+
+public:
+    explicit LRUPolicy(int frames);
+    void accessed(int frame) override;
+    void loaded(int frame, long long page) override;
+    int victim(long long page) override;
+};
+
+
+class ClockPolicy : public ReplacementPolicy {
+    /*CLOCK (segunda oportunidad): la manecilla recorre los marcos y le quita el bit de
+     * referencia a cada uno hasta encontrar uno que no se haya usado desde la última vuelta.
+    */
+    std::vector<bool> referenced;
+    int hand = 0;
+
+public:
+    explicit ClockPolicy(int frames);
+    void accessed(int frame) override;
+    void loaded(int frame, long long page) override;
+    int victim(long long page) override;
+};
+
+
+class LFUPolicy : public ReplacementPolicy {
+    /*LFU en O(1): una lista de cubetas ordenadas por frecuencia, cada una con sus marcos en
+     * orden LRU. Un acceso mueve el marco a la cubeta siguiente y la víctima es el marco más
+     * viejo de la primera cubeta.
+    */
+    struct Bucket {
+        unsigned long long count;
+        std::list<int> frames;
+    };
+
+    std::list<Bucket> buckets;
+    std::vector<std::list<Bucket>::iterator> bucketOf;
+    std::vector<std::list<int>::iterator> position;
+
+public:
+    explicit LFUPolicy(int frames);
+    void accessed(int frame) override;
+    void loaded(int frame, long long page) override;
+    int victim(long long page) override;
+};
+
+
+class ARCPolicy : public ReplacementPolicy {
+    /*ARC (Adaptive Replacement Cache): T1 guarda las páginas vistas una vez y T2 las vistas
+     * más de una vez; B1 y B2 recuerdan las páginas que salieron de cada una. Un fallo que
+     * acierta en B1 o B2 mueve el objetivo p para darle más marcos a la lista que lo necesita.
+    */
+    enum ListId { T1, T2, B1, B2 };
+
+    int capacity;
+    int target = 0;  // p: tamaño deseado de T1
+    std::list<long long> lists[4];  // T1 y T2 guardan marcos, B1 y B2 números de página
+    std::vector<ListId> frameList;
+    std::vector<std::list<long long>::iterator> framePosition;
+    std::vector<long long> framePage;
+    typedef std::unordered_map<long long, std::pair<ListId, std::list<long long>::iterator> >
+        GhostMap;
+    GhostMap ghosts;
+
+    void forgetGhost(ListId list);
+    int replace(bool hitInB2);
+
+public:
+    explicit ARCPolicy(int frames);
+    void accessed(int frame) override;
+    void loaded(int frame, long long page) override;
+    int victim(long long page) override;
+    int targetSize() const { return target; }
+};
+
+
+class TwoQueuePolicy : public ReplacementPolicy {
+    /*2Q: las páginas nuevas entran a la cola FIFO A1in; si se vuelven a pedir después de
+     * salir (siguen en la cola fantasma A1out) pasan a Am, que se maneja con LRU. Así un
+     * recorrido secuencial no desplaza a las páginas que sí se reutilizan.
+    */
+    int inCapacity;
+    int outCapacity;
+    std::list<int> a1in, am;  // marcos
+    std::list<long long> a1out;  // números de página
+    std::vector<bool> inAm;
+    std::vector<std::list<int>::iterator> framePosition;
+    std::vector<long long> framePage;
+    std::unordered_map<long long, std::list<long long>::iterator> ghosts;
+
+public:
+    explicit TwoQueuePolicy(int frames);
+    void accessed(int frame) override;
+    void loaded(int frame, long long page) override;
+    int victim(long long page) override;
+};
+
+
+std::unique_ptr<ReplacementPolicy> makeReplacementPolicy(const std::string& name, int frames);
+
+#endif
@@ -1,9 +1,36 @@
 #include <gtest/gtest.h>
 #include "pagesort.h"
+#include "replacement.h"
+#include "textio.h"
+#include "pagestore.h"
+#include "pagedarray.h"
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <limits>
 
 
+// Números pseudoaleatorios siempre iguales para la misma semilla: (x % mod) + offset, con x de
+// 24 bits; con mod 0 son enteros de 32 bits cualesquiera, negativos incluidos
+static std::vector<int> randomInts(unsigned int seed, int n, int mod, int offset) {
+    std::vector<int> numbers;
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245 + 12345;
+        numbers.push_back(mod ? static_cast<int>(seed >> 8) % mod + offset
+                              : static_cast<int>(seed));
+    }
+    return numbers;
+}
+
+// Lo que debería quedar en el archivo después de ordenar numbers
+template <class T>
+static std::vector<T> sortedCopy(std::vector<T> numbers) {
+    std::sort(numbers.begin(), numbers.end());
+    return numbers;
+}
+
 // Test para convertToBinary
 TEST(PagedSortTest, ConvertToBinaryTest) {
     std::string testInputFile = "test_input.txt";
@@ -32,3 +59,968 @@ TEST(PagedSortTest, ConvertToBinaryTest) {
     std::remove(testBinaryFile.c_str());
 }
 
+
+// Test para externalMergeSort
+TEST(PagedSortTest, ExternalMergeSortTest) {
+    std::string testBinaryFile = "test_merge.bin";
+
+    // Suficientes números para necesitar varias pasadas de mezcla
+    std::vector<int> numbers = randomInts(12345, 20000, 5000, -2500);
+
+    std::ofstream out(testBinaryFile, std::ios::binary);
+    out.write(reinterpret_cast<char*>(numbers.data()), numbers.size() * sizeof(int));
+    out.close();
+
+    externalMergeSort(testBinaryFile);
+
+    std::ifstream in(testBinaryFile, std::ios::binary);
+    int number;
+    std::vector<int> sorted;
+    while (in.read(reinterpret_cast<char*>(&number), sizeof(int))) {
+        sorted.push_back(number);
+    }
+    in.close();
+
+    ASSERT_EQ(sorted, sortedCopy(numbers));
+
+    std::remove(testBinaryFile.c_str());
+}
+
+// Escribe numbers en binaryFile, lo ordena con sortBinaryFile y deja en sorted lo que quedó
+// en el archivo
+template <class T>
+static bool sortThroughFile(const std::string& binaryFile, const std::vector<T>& numbers,
+                            const std::string& algorithm, const PagingConfig& config,
+                            std::vector<T>& sorted) {
+    std::ofstream out(binaryFile, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(numbers.data()), numbers.size() * sizeof(T));
+    out.close();
+
+    if (!sortBinaryFile(binaryFile, algorithm, config)) {
+        return false;
+    }
+
+    std::ifstream in(binaryFile, std::ios::binary);
+    T number;
+    sorted.clear();
+    while (in.read(reinterpret_cast<char*>(&number), sizeof(T))) {
+        sorted.push_back(number);
+    }
+    return true;
+}
+
+// Test para las políticas de reemplazo: ordenar con QS usando cada una
+TEST(PagedSortTest, ReplacementPoliciesSortTest) {
+    std::string testBinaryFile = "test_policy.bin";
+    const char* policies[] = { "LRU", "CLOCK", "LFU", "ARC", "2Q" };
+
+    std::vector<int> numbers = randomInts(777, 8000, 10000, 0);
+    std::vector<int> expected = sortedCopy(numbers);
+
+    for (const char* policy : policies) {
+        PagingConfig config;
+        config.policy = policy;
+        std::vector<int> sorted;
+        ASSERT_TRUE(sortThroughFile(testBinaryFile, numbers, "QS", config, sorted));
+
+        ASSERT_EQ(sorted, expected) << "Política " << policy;
+    }
+
+    std::remove(testBinaryFile.c_str());
+}
+
+// Test de IS con políticas que no sacan siempre la página usada hace más tiempo: el elemento
+// que se corre de una página a otra no puede leerse de un marco que la escritura reemplazó
+TEST(PagedSortTest, InsertionSortPoliciesTest) {
+    std::string testBinaryFile = "test_is_policy.bin";
+    const char* policies[] = { "LFU", "ARC", "CLOCK", "2Q" };
+    const char* backends[] = { "stream", "mmap" };
+
+    std::vector<int> numbers = randomInts(8192, 2000, 100000, -50000);
+    std::vector<int> expected = sortedCopy(numbers);
+
+    for (const char* policy : policies) {
+        for (const char* backend : backends) {
+            PagingConfig config;
+            config.policy = policy;
+            config.backend = backend;
+            std::vector<int> sorted;
+            ASSERT_TRUE(sortThroughFile(testBinaryFile, numbers, "IS", config, sorted));
+
+            ASSERT_EQ(sorted, expected) << "Política " << policy << " con " << backend;
+        }
+    }
+
+    std::remove(testBinaryFile.c_str());
+}
+
+// Test para LRUPolicy: la víctima es siempre el marco usado hace más tiempo
+TEST(PagedSortTest, LRUPolicyVictimTest) {
+    LRUPolicy lru(3);
+    lru.loaded(0, 10);
+    lru.loaded(1, 11);
+    lru.loaded(2, 12);
+    lru.accessed(0);
+
+    ASSERT_EQ(lru.victim(13), 1);
+    lru.loaded(1, 13);
+    ASSERT_EQ(lru.victim(14), 2);
+}
+
+// Test para ClockPolicy: un marco usado desde la última vuelta de la manecilla se salva una vez
+TEST(PagedSortTest, ClockPolicySecondChanceTest) {
+    ClockPolicy clock(3);
+    clock.loaded(0, 10);
+    clock.loaded(1, 11);
+    clock.loaded(2, 12);
+
+    // Todos tienen el bit prendido: la manecilla los apaga y vuelve al primero
+    ASSERT_EQ(clock.victim(13), 0);
+    clock.loaded(0, 13);
+    clock.accessed(1);
+    ASSERT_EQ(clock.victim(14), 2);
+    clock.loaded(2, 14);
+    // El marco 1 ya gastó su segunda oportunidad
+    ASSERT_EQ(clock.victim(15), 1);
+}
+
+// Test para LFUPolicy: la víctima es el marco con menos accesos, y entre iguales el más viejo
+TEST(PagedSortTest, LFUPolicyVictimTest) {
+    LFUPolicy lfu(3);
+    lfu.loaded(0, 10);
+    lfu.loaded(1, 11);
+    lfu.loaded(2, 12);
+    lfu.accessed(0);
+    lfu.accessed(0);
+    lfu.accessed(2);
+
+    ASSERT_EQ(lfu.victim(13), 1);
+    lfu.loaded(1, 13);
+    lfu.accessed(1);
+    lfu.accessed(1);
+    lfu.accessed(1);
+    ASSERT_EQ(lfu.victim(14), 2);
+    lfu.loaded(2, 14);
+    lfu.accessed(2);
+    lfu.accessed(2);
+    // 0 y 2 tienen 3 accesos: sale 0, que llegó a esa cuenta antes
+    ASSERT_EQ(lfu.victim(15), 0);
+}
+
+// Test para ARCPolicy: un fallo que acierta en la lista fantasma B1 agranda el objetivo p de T1
+// y uno que acierta en B2 lo achica
+TEST(PagedSortTest, ARCPolicyGhostTargetTest) {
+    ARCPolicy arc(4);
+    arc.loaded(0, 10);
+    arc.loaded(1, 11);
+    arc.accessed(0);  // la página 10 pasa a T2
+    arc.loaded(2, 12);
+    arc.loaded(3, 13);
+    ASSERT_EQ(arc.targetSize(), 0);
+
+    // Sale la página 11, la más vieja de T1, y queda en B1
+    ASSERT_EQ(arc.victim(14), 1);
+    arc.loaded(1, 14);
+    ASSERT_EQ(arc.targetSize(), 0);
+
+    // Volver a pedir la 11 acierta en B1
+    int frame = arc.victim(11);
+    ASSERT_EQ(arc.targetSize(), 1);
+    arc.loaded(frame, 11);
+
+    // Sacar la página 10 de T2 y volver a pedirla acierta en B2
+    arc.accessed(frame);
+    arc.accessed(2);
+    arc.accessed(3);
+    arc.accessed(1);
+    ASSERT_EQ(arc.victim(15), 0);
+    arc.loaded(0, 15);
+    arc.victim(10);
+    ASSERT_EQ(arc.targetSize(), 0);
+}
+
+// Test para TwoQueuePolicy: una página que se reutilizó no sale por un recorrido de una sola
+// pasada sobre páginas nuevas, aunque el recorrido no la vuelva a tocar (con LRU saldría)
+TEST(PagedSortTest, TwoQueuePolicyScanTest) {
+    TwoQueuePolicy twoQueue(4);
+    for (int frame = 0; frame < 4; frame++) {
+        twoQueue.loaded(frame, 100 + frame);
+    }
+    // La página 100 sale de A1in y se vuelve a pedir mientras sigue en A1out: pasa a Am
+    ASSERT_EQ(twoQueue.victim(104), 0);
+    twoQueue.loaded(0, 104);
+    int hot = twoQueue.victim(100);
+    twoQueue.loaded(hot, 100);
+
+    for (long long page = 200; page < 300; page++) {
+        int frame = twoQueue.victim(page);
+        ASSERT_NE(frame, hot) << "la página " << page << " sacó a la reutilizada";
+        twoQueue.loaded(frame, page);
+    }
+}
+
+// Test para PagingConfig: tamaños de página fijos en compilación y en tiempo de ejecución
+TEST(PagedSortTest, ConfigurablePagingTest) {
+    std::string testBinaryFile = "test_config.bin";
+    const int pageSizes[] = { 100, 1024 };
+    const char* algorithms[] = { "QS", "MS" };
+
+    std::vector<int> numbers = randomInts(4242, 6000, 3000, -1500);
+    std::vector<int> expected = sortedCopy(numbers);
+
+    for (int pageSize : pageSizes) {
+        for (const char* algorithm : algorithms) {
+            PagingConfig config;
+            config.pageBytes = pageSize * sizeof(int);
+            config.frames = 3;
+            std::vector<int> sorted;
+            ASSERT_TRUE(sortThroughFile(testBinaryFile, numbers, algorithm, config, sorted));
+
+            ASSERT_EQ(sorted, expected) << algorithm << " con páginas de " << pageSize;
+        }
+    }
+
+    std::remove(testBinaryFile.c_str());
+}
+
+// Test para la tabla de páginas: muchos marcos y muchas páginas para forzar colisiones
+TEST(PagedSortTest, PageTableManyFramesTest) {
+    std::string testBinaryFile = "test_page_table.bin";
+
+    std::vector<int> numbers = randomInts(99, 6000, 100000, 0);
+    std::vector<int> expected = sortedCopy(numbers);
+
+    PagingConfig config;
+    config.pageBytes = 16 * sizeof(int);
+    config.frames = 50;
+    config.policy = "ARC";
+    std::vector<int> sorted;
+    ASSERT_TRUE(sortThroughFile(testBinaryFile, numbers, "QS", config, sorted));
+
+    ASSERT_EQ(sorted, expected);
+
+    std::remove(testBinaryFile.c_str());
+}
+
+// Test para el backend mmap: mismo resultado que con fstream
+TEST(PagedSortTest, MappedBackendTest) {
+    std::string testBinaryFile = "test_mmap.bin";
+    const char* algorithms[] = { "QS", "IS" };
+
+    std::vector<int> numbers = randomInts(2024, 3000, 20000, -10000);
+    std::vector<int> expected = sortedCopy(numbers);
+
+    for (const char* algorithm : algorithms) {
+        PagingConfig config;
+        config.backend = "mmap";
+        config.pageBytes = 1024 * sizeof(int);
+        config.frames = 3;
+        std::vector<int> sorted;
+        ASSERT_TRUE(sortThroughFile(testBinaryFile, numbers, algorithm, config, sorted));
+
+        ASSERT_EQ(sorted, expected) << algorithm;
+    }
+
+    std::remove(testBinaryFile.c_str());
+}
+
+#ifdef __linux__
+static long long residentFileBytes() {
+    // Memoria de archivos mapeados que el proceso tiene en RAM (RssFile, en kB)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 8, "RssFile:") == 0) {
+            return std::stoll(line.substr(8)) * 1024;
+        }
+    }
+    return -1;
+}
+
+// Test para el backend mmap: con accesos al azar lo que el proceso tiene del archivo no pasa
+// de los marcos, aunque el archivo entero esté en la caché del sistema
+TEST(PagedSortTest, MappedResidencyTest) {
+    std::string testBinaryFile = "test_residency.bin";
+    const int frames = 6;
+    const int pageSize = static_cast<int>(systemPageBytes() * 4 / sizeof(int));
+    const long long pageBytes = pageSize * static_cast<long long>(sizeof(int));
+    const long long pages = 1024;
+
+    {
+        std::vector<int> numbers(pages * pageSize, 1);
+        std::ofstream out(testBinaryFile, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<char*>(numbers.data()), numbers.size() * sizeof(int));
+    }
+
+    std::unique_ptr<PageStore> store =
+        makePageStore("mmap", testBinaryFile, sizeof(int), pageSize, frames);
+    ASSERT_TRUE(store && store->isOpen());
+
+    // La medida empieza con los marcos ya llenos (y el código de la prueba ya cargado): de
+    // ahí en más lo residente no debería crecer más que lo que ocupa un juego de marcos
+    std::vector<long long> loaded(frames, -1);
+    long long before = -1;
+    long long peak = 0;
+    unsigned int seed = 5;
+    for (int i = 0; i < 20000; i++) {
+        seed = seed * 1103515245 + 12345;
+        long long page = (seed >> 8) % pages;
+        int frame = i % frames;
+        if (loaded[frame] != -1) {
+            store->evict(loaded[frame], frame, true);
+        }
+        int* data = reinterpret_cast<int*>(store->load(page, frame));
+        loaded[frame] = page;
+        for (int k = 0; k < pageSize; k += 256) {
+            data[k] += 1;
+        }
+        if (i == 2 * frames) {
+            before = residentFileBytes();
+            ASSERT_GE(before, 0);
+        } else if (i % 1000 == 999) {
+            peak = std::max(peak, residentFileBytes() - before);
+        }
+    }
+    ASSERT_LE(peak, frames * (pageBytes + systemPageBytes()));
+
+    store.reset();
+    std::remove(testBinaryFile.c_str());
+}
+#endif
+
+// Test para la E/S asíncrona: lectura adelantada y escritura en segundo plano
+TEST(PagedSortTest, AsyncReadAheadTest) {
+    std::string testBinaryFile = "test_async.bin";
+    const char* algorithms[] = { "QS", "PS" };
+
+    std::vector<int> numbers = randomInts(31337, 2000, 5000, -2500);
+    std::vector<int> expected = sortedCopy(numbers);
+
+    for (const char* algorithm : algorithms) {
+        PagingConfig config;
+        config.pageBytes = 64 * sizeof(int);
+        config.frames = 8;
+        config.readAhead = 3;
+        std::vector<int> sorted;
+        ASSERT_TRUE(sortThroughFile(testBinaryFile, numbers, algorithm, config, sorted));
+
+        ASSERT_EQ(sorted, expected) << algorithm;
+    }
+
+    std::remove(testBinaryFile.c_str());
+}
+
+// Test para TextReader: negativos, espacios y números partidos entre bloques
+TEST(PagedSortTest, TextReaderChunkBoundaryTest) {
+    std::string testInputFile = "test_reader.txt";
+
+    std::ofstream out(testInputFile);
+    out << "12345,-678, 9,\n-2147483648,2147483647 ,+42,0\r\n";
+    out.close();
+
+    // Bloques de 3 bytes: casi todos los números quedan partidos
+    TextReader reader(testInputFile, 3);
+    std::vector<int> numbers(4);
+    std::vector<int> parsed;
+    std::size_t count;
+    while ((count = reader.read(numbers.data(), numbers.size())) > 0) {
+        parsed.insert(parsed.end(), numbers.begin(), numbers.begin() + count);
+    }
+
+    ASSERT_EQ(parsed, std::vector<int>({ 12345, -678, 9, -2147483648, 2147483647, 42, 0 }));
+
+    std::remove(testInputFile.c_str());
+}
+
+// Lee con TextReader todos los números de text que caben en T, en bloques de chunkSize bytes
+template <class T>
+static std::vector<T> readAll(const std::string& text, std::size_t chunkSize) {
+    std::string testInputFile = "test_overflow.txt";
+    {
+        std::ofstream out(testInputFile);
+        out << text;
+    }
+    std::vector<T> parsed;
+    {
+        TextReader reader(testInputFile, chunkSize);
+        std::vector<T> numbers(4);
+        std::size_t count;
+        while ((count = reader.read(numbers.data(), numbers.size())) > 0) {
+            parsed.insert(parsed.end(), numbers.begin(), numbers.begin() + count);
+        }
+    }
+    std::remove(testInputFile.c_str());
+    return parsed;
+}
+
+// Test para TextReader: un entero que no cabe en el tipo corta la lectura como operator>>,
+// en lugar de guardar el valor recortado
+TEST(PagedSortTest, TextReaderOverflowTest) {
+    for (std::size_t chunkSize : { static_cast<std::size_t>(3), TEXT_CHUNK }) {
+        ASSERT_EQ(readAll<int>("1,2147483647,-2147483648,3000000000,5", chunkSize),
+                  std::vector<int>({ 1, 2147483647, -2147483648 }));
+        ASSERT_EQ(readAll<int>("7,-2147483649,5", chunkSize), std::vector<int>({ 7 }));
+        ASSERT_EQ(readAll<int>("7,2147483648", chunkSize), std::vector<int>({ 7 }));
+        ASSERT_EQ(readAll<long long>("9223372036854775807,-9223372036854775808,"
+                                     "9223372036854775808,1", chunkSize),
+                  std::vector<long long>({ LLONG_MAX, LLONG_MIN }));
+        ASSERT_EQ(readAll<unsigned long long>("18446744073709551615,18446744073709551616",
+                                              chunkSize),
+                  std::vector<unsigned long long>({ ULLONG_MAX }));
+        // Más de 20 dígitos también se pasan de 64 bits, aunque el valor acumulado dé la vuelta
+        ASSERT_EQ(readAll<unsigned long long>("3,100000000000000000000000,4", chunkSize),
+                  std::vector<unsigned long long>({ 3 }));
+        ASSERT_EQ(readAll<unsigned long long>("3,-0,-1,4", chunkSize),
+                  std::vector<unsigned long long>({ 3, 0 }));
+        // Un campo vacío o un signo sin dígitos también cortan la lectura, como operator>>
+        ASSERT_EQ(readAll<int>("1,,2", chunkSize), std::vector<int>({ 1 }));
+        ASSERT_EQ(readAll<int>(",1", chunkSize), std::vector<int>());
+        ASSERT_EQ(readAll<int>("4, ,5", chunkSize), std::vector<int>({ 4 }));
+        ASSERT_EQ(readAll<int>("4,-,5", chunkSize), std::vector<int>({ 4 }));
+        ASSERT_EQ(readAll<int>("4,+ 5", chunkSize), std::vector<int>({ 4 }));
+        ASSERT_EQ(readAll<int>("4,+-5", chunkSize), std::vector<int>({ 4 }));
+        ASSERT_EQ(readAll<int>("-1, +2\n3 ,4,\n", chunkSize), std::vector<int>({ -1, 2, 3, 4 }));
+        ASSERT_EQ(readAll<double>("1.5,,2", chunkSize), std::vector<double>({ 1.5 }));
+        ASSERT_EQ(readAll<double>("1.5, -,2", chunkSize), std::vector<double>({ 1.5 }));
+    }
+}
+
+// Test para convertToText: ida y vuelta con convertToBinary
+TEST(PagedSortTest, ConvertRoundTripTest) {
+    std::string testInputFile = "test_roundtrip.txt";
+    std::string testBinaryFile = "test_roundtrip.bin";
+    std::string testOutputFile = "test_roundtrip_out.txt";
+    std::string text = "-2147483648,-100,-9,0,7,10,99,100,65536,2147483647";
+
+    std::ofstream out(testInputFile);
+    out << text;
+    out.close();
+
+    convertToBinary(testInputFile, testBinaryFile);
+    convertToText(testBinaryFile, testOutputFile);
+
+    std::ifstream in(testOutputFile);
+    std::string result((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    ASSERT_EQ(result, text);
+
+    std::remove(testInputFile.c_str());
+    std::remove(testBinaryFile.c_str());
+    std::remove(testOutputFile.c_str());
+}
+
+TEST(PagedSortTest, SortTextFileTest) {
+    std::string testInputFile = "test_fused.txt";
+    std::string testBinaryFile = "test_fused.bin";
+    std::string testOutputFile = "test_fused_out.txt";
+
+    // 3 marcos de 4 enteros: 100 números obligan a varias pasadas de mezcla
+    PagingConfig config;
+    config.pageBytes = 4 * sizeof(int);
+    config.frames = 3;
+
+    for (int total : {10, 100}) {
+        std::vector<int> numbers;
+        std::ofstream out(testInputFile);
+        for (int i = 0; i < total; i++) {
+            numbers.push_back((i * 37) % 101 - 50);
+            out << (i ? "," : "") << numbers.back();
+        }
+        out.close();
+        std::sort(numbers.begin(), numbers.end());
+
+        ASSERT_TRUE(sortTextFile(testInputFile, testOutputFile, testBinaryFile, "MS", config));
+
+        std::string expected;
+        for (std::size_t i = 0; i < numbers.size(); i++) {
+            expected += (i ? "," : "") + std::to_string(numbers[i]);
+        }
+        std::ifstream in(testOutputFile);
+        std::string result((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+
+        ASSERT_EQ(result, expected);
+        ASSERT_FALSE(std::ifstream(testBinaryFile).good());
+        ASSERT_FALSE(std::ifstream(testBinaryFile + ".runs").good());
+    }
+
+    std::remove(testInputFile.c_str());
+    std::remove(testOutputFile.c_str());
+}
+
+// Test del modo con varios hilos: cada hilo ordena su rango y después se mezclan
+TEST(PagedSortTest, ParallelSortTest) {
+    std::string testBinaryFile = "test_parallel.bin";
+    const char* algorithms[] = { "QS", "IS", "MS" };
+    const char* backends[] = { "stream", "mmap" };
+
+    std::vector<int> numbers = randomInts(777, 3001, 5000, -2500);
+    std::vector<int> expected = sortedCopy(numbers);
+
+    for (const char* algorithm : algorithms) {
+        for (const char* backend : backends) {
+            PagingConfig config;
+            config.pageBytes = 64 * sizeof(int);
+            config.frames = 10;
+            config.backend = backend;
+            config.threads = 3;
+            std::vector<int> sorted;
+            ASSERT_TRUE(sortThroughFile(testBinaryFile, numbers, algorithm, config, sorted));
+
+            ASSERT_EQ(sorted, expected) << algorithm << " con " << backend;
+        }
+    }
+
+    std::remove(testBinaryFile.c_str());
+}
+
+// Test de las estadísticas: repetir la traza con la misma configuración da los mismos contadores
+TEST(PagedSortTest, StatsTraceReplayTest) {
+    std::string testBinaryFile = "test_stats.bin";
+    std::string testTraceFile = "test_stats.trace";
+    const char* policies[] = { "LRU", "CLOCK" };
+
+    std::vector<int> numbers = randomInts(99, 1024, 1000, 0);
+
+    for (const char* policy : policies) {
+        PagingStats stats;
+        PagingConfig config;
+        config.pageBytes = 32 * sizeof(int);
+        config.frames = 4 + PARTITION_FRAMES;  // QS deja 4 marcos para el arreglo
+        config.policy = policy;
+        config.stats = &stats;
+        config.trace = testTraceFile;
+        std::vector<int> sorted;
+        ASSERT_TRUE(sortThroughFile(testBinaryFile, numbers, "QS", config, sorted));
+        ASSERT_TRUE(std::is_sorted(sorted.begin(), sorted.end()));
+
+        ASSERT_GT(stats.misses, 0);
+        ASSERT_EQ(stats.hits + stats.misses, stats.accesses);
+        // Cada fallo después de llenar los marcos saca una página
+        ASSERT_EQ(stats.cleanEvictions + stats.dirtyEvictions, stats.misses - 4);
+        long long pages = 0;
+        for (std::size_t k = 0; k < stats.faultHistogram.size(); k++) {
+            pages += stats.faultHistogram[k];
+        }
+        ASSERT_EQ(pages, 1024 / 32);
+
+        // La traza es del arreglo, que ordenó sin los marcos de los bloques de partition
+        PagingConfig replayConfig = config;
+        replayConfig.frames -= PARTITION_FRAMES;
+        PagingStats replay = replayTrace(testTraceFile, replayConfig);
+        ASSERT_EQ(replay.accesses, stats.accesses) << policy;
+        ASSERT_EQ(replay.misses, stats.misses) << policy;
+        ASSERT_EQ(replay.cleanEvictions, stats.cleanEvictions) << policy;
+        ASSERT_EQ(replay.dirtyEvictions, stats.dirtyEvictions) << policy;
+        ASSERT_EQ(replay.bytesRead, stats.bytesRead) << policy;
+        ASSERT_EQ(replay.bytesWritten, stats.bytesWritten) << policy;
+        ASSERT_EQ(replay.faultHistogram, stats.faultHistogram) << policy;
+    }
+
+    std::remove(testBinaryFile.c_str());
+    std::remove(testTraceFile.c_str());
+}
+
+// Test de los ciclos por página: entradas que llevan la partición por bloques y los
+// corrimientos entre páginas a sus casos borde
+TEST(PagedSortTest, PageSpanKernelsTest) {
+    std::string testBinaryFile = "test_spans.bin";
+    const char* algorithms[] = { "QS", "IS", "SS", "PS" };
+    const int n = 700;
+
+    std::vector<std::vector<int> > inputs(4);
+    inputs[0] = randomInts(31337, n, 0, 0);  // aleatorios
+    inputs[3] = randomInts(31337, n, 3, 0);  // muchos repetidos
+    for (int i = 0; i < n; i++) {
+        inputs[1].push_back(i);      // ordenados
+        inputs[2].push_back(n - i);  // al revés
+    }
+
+    for (const char* algorithm : algorithms) {
+        for (std::size_t input = 0; input < inputs.size(); input++) {
+            std::vector<int> expected = sortedCopy(inputs[input]);
+
+            // Páginas de 7 enteros: ni los bloques ni el final del archivo caen alineados
+            PagingConfig config;
+            config.pageBytes = 7 * sizeof(int);
+            config.frames = 3;
+            config.policy = "CLOCK";
+            std::vector<int> sorted;
+            ASSERT_TRUE(sortThroughFile(testBinaryFile, inputs[input], algorithm, config, sorted));
+
+            ASSERT_EQ(sorted, expected) << algorithm << " con la entrada " << input;
+        }
+    }
+
+    std::remove(testBinaryFile.c_str());
+}
+
+// Test para el radix sort: negativos, extremos y distintas cantidades de pasadas
+TEST(PagedSortTest, RadixSortTest) {
+    std::string testBinaryFile = "test_radix.bin";
+    const int frames[] = { 3, 6, 300 };
+
+    std::vector<int> numbers = randomInts(2024, 5000, 0, 0);
+    numbers.insert(numbers.end(), { 2147483647, -2147483647 - 1, 0, -1, 1 });
+    std::vector<int> expected = sortedCopy(numbers);
+
+    for (int f : frames) {
+        PagingConfig config;
+        config.pageBytes = 50 * sizeof(int);
+        config.frames = f;
+        std::vector<int> sorted;
+        ASSERT_TRUE(sortThroughFile(testBinaryFile, numbers, "RS", config, sorted));
+
+        ASSERT_EQ(sorted, expected) << "con " << f << " marcos";
+        ASSERT_FALSE(std::ifstream(testBinaryFile + ".radix").good());
+    }
+
+    std::remove(testBinaryFile.c_str());
+}
+
+// Test de índices de 64 bits: un archivo disperso de más de 2^31 enteros no ocupa disco, pero
+// obliga a que conteos, desplazamientos y números de página no se corten en 32 bits
+TEST(PagedSortTest, LargeFileOffsetsTest) {
+    std::string testBinaryFile = "test_large.bin";
+    const long long total = (1LL << 31) + 1000;
+    const char* backends[] = { "stream", "mmap", "stream" };
+    const int readAhead[] = { 0, 0, 2 };
+
+    {
+        std::ofstream out(testBinaryFile, std::ios::binary | std::ios::trunc);
+        out.seekp((total - 1) * sizeof(int));
+        int last = 0;
+        out.write(reinterpret_cast<char*>(&last), sizeof(int));
+    }
+    ASSERT_EQ(getTotalNumbersInFile(testBinaryFile), total);
+    ASSERT_GT(getTotalNumbersInFile(testBinaryFile), INT_MAX);
+
+    for (int b = 0; b < 3; b++) {
+        std::unique_ptr<PageStore> store;
+        // Con páginas de un entero el número de la última página también pasa de 2^31
+        store = makePageStore(backends[b], testBinaryFile, sizeof(int), 1, 2, readAhead[b]);
+        ASSERT_TRUE(store && store->isOpen()) << backends[b];
+        ASSERT_EQ(store->elements(), total);
+        int* page = reinterpret_cast<int*>(store->load(total - 1, 0));
+        page[0] = 1000 + b;
+        store->evict(total - 1, 0, true);
+
+        // Un rango que empieza pasados los 8 GB, con la última página incompleta
+        store = makePageStore(backends[b], testBinaryFile, sizeof(int), 64, 2, readAhead[b],
+                              total - 200);
+        ASSERT_EQ(store->elements(), 200);
+        page = reinterpret_cast<int*>(store->load(2, 1));
+        // Lo que dejó el backend anterior
+        ASSERT_EQ(page[0], b == 0 ? 0 : (b - 1) * 100) << backends[b];
+        for (int k = 0; k < 8; k++) {
+            page[k] = b * 100 + k;
+        }
+        store->evict(2, 1, true);
+        store.reset();
+
+        std::ifstream in(testBinaryFile, std::ios::binary);
+        in.seekg((total - 200 + 2 * 64) * sizeof(int));
+        int numbers[8];
+        in.read(reinterpret_cast<char*>(numbers), sizeof(numbers));
+        ASSERT_EQ(in.gcount(), static_cast<std::streamsize>(sizeof(numbers))) << backends[b];
+        for (int k = 0; k < 8; k++) {
+            ASSERT_EQ(numbers[k], b * 100 + k) << backends[b];
+        }
+        int last;
+        in.seekg((total - 1) * sizeof(int));
+        in.read(reinterpret_cast<char*>(&last), sizeof(int));
+        ASSERT_EQ(last, 1000 + b) << backends[b];
+    }
+    std::remove(testBinaryFile.c_str());
+
+    // La traza de un arreglo así tiene índices que no caben en un int
+    std::string testTraceFile = "test_large.trace";
+    {
+        std::ofstream trace(testTraceFile, std::ios::trunc);
+        trace << "W " << total - 2 << "\nR " << total - 1 << "\nR 0\n";
+    }
+    PagingConfig config;
+    config.pageBytes = 4 * sizeof(int);
+    config.frames = 2;
+    PagingStats replay = replayTrace(testTraceFile, config);
+    ASSERT_EQ(replay.accesses, 3);
+    ASSERT_EQ(replay.misses, 2);
+    ASSERT_EQ(replay.bytesWritten, 4 * static_cast<long long>(sizeof(int)));
+    ASSERT_EQ(replay.faultHistogram[0], total / 4 - 2);
+    std::remove(testTraceFile.c_str());
+}
+
+// Test del quicksort iterativo: entradas que con el pivote fijo en el último elemento
+// llevaban la recursión a una profundidad lineal
+TEST(PagedSortTest, QuickSortDepthTest) {
+    std::string testBinaryFile = "test_depth.bin";
+    const int n = 100000;
+
+    std::vector<std::vector<int> > inputs(4);
+    for (int i = 0; i < n; i++) {
+        inputs[0].push_back(i);                              // ordenados
+        inputs[1].push_back(7);                              // todos iguales
+        inputs[2].push_back(i < n / 2 ? i : n - i);          // subida y bajada
+        inputs[3].push_back(i % 2 ? i : n - i);              // intercalados
+    }
+
+    for (std::size_t input = 0; input < inputs.size(); input++) {
+        std::vector<int> expected = sortedCopy(inputs[input]);
+
+        PagingConfig config;
+        config.pageBytes = 16 * sizeof(int);
+        config.frames = 8;
+        std::vector<int> sorted;
+        ASSERT_TRUE(sortThroughFile(testBinaryFile, inputs[input], "QS", config, sorted));
+
+        ASSERT_EQ(sorted, expected) << "con la entrada " << input;
+    }
+
+    std::remove(testBinaryFile.c_str());
+}
+
+// Test de los tipos de -t: cada algoritmo sobre enteros de 64 bits y double, con los
+// valores extremos de cada tipo
+template <class T, class Less>
+static void checkTypedSort(const std::string& type, std::vector<T> numbers, Less less) {
+    std::string testBinaryFile = "test_typed.bin";
+    std::vector<T> expected = numbers;
+    std::sort(expected.begin(), expected.end(), less);
+    const char* algorithms[] = { "QS", "IS", "MS", "RS" };
+
+    for (const char* algorithm : algorithms) {
+        for (int threads = 1; threads <= 2; threads++) {
+            PagingConfig config;
+            ASSERT_TRUE(parseElementType(type, config.element));
+            config.pageBytes = 256;
+            config.frames = 8;
+            config.threads = threads;
+            std::vector<T> sorted;
+            ASSERT_TRUE(sortThroughFile(testBinaryFile, numbers, algorithm, config, sorted));
+            ASSERT_EQ(sorted.size(), expected.size());
+
+            // Comparar los bytes: NaN no es igual a sí mismo
+            ASSERT_EQ(std::memcmp(sorted.data(), expected.data(), sorted.size() * sizeof(T)), 0)
+                << type << " con " << algorithm << " y " << threads << " hilos";
+        }
+    }
+    std::remove(testBinaryFile.c_str());
+}
+
+TEST(PagedSortTest, TypedSortTest) {
+    const int n = 3000;
+    std::vector<long long> signed64;
+    std::vector<unsigned long long> unsigned64;
+    std::vector<double> doubles;
+    unsigned long long seed = 12345;
+    for (int i = 0; i < n; i++) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        signed64.push_back(static_cast<long long>(seed % 2000) * 1000000007LL * (i % 2 ? 1 : -1));
+        unsigned64.push_back(seed >> (i % 40));
+        doubles.push_back((static_cast<double>(seed >> 11) - 4.5e15) / 1e10);
+    }
+    signed64.push_back(LLONG_MIN);
+    signed64.push_back(LLONG_MAX);
+    unsigned64.push_back(ULLONG_MAX);
+    unsigned64.push_back(0);
+    doubles.push_back(std::numeric_limits<double>::quiet_NaN());
+    doubles.push_back(std::numeric_limits<double>::infinity());
+    doubles.push_back(-std::numeric_limits<double>::infinity());
+    doubles.push_back(std::numeric_limits<double>::denorm_min());
+    doubles.push_back(-std::numeric_limits<double>::max());
+
+    checkTypedSort("i64", signed64, std::less<long long>());
+    checkTypedSort("u64", unsigned64, std::less<unsigned long long>());
+    checkTypedSort("f64", doubles, [](double a, double b) { return a < b || (b != b && a == a); });
+}
+
+// Test de la conversión de texto con -t: los números de 64 bits y los double salen igual
+// que entraron
+TEST(PagedSortTest, TypedTextTest) {
+    std::string testInputFile = "test_typed.txt";
+    std::string testOutputFile = "test_typed_out.txt";
+    std::string testBinaryFile = "test_typed_text.bin";
+    const char* algorithms[] = { "QS", "MS" };
+
+    std::ofstream out(testInputFile);
+    out << "9223372036854775807,-9223372036854775808,42,-1,0";
+    out.close();
+    for (const char* algorithm : algorithms) {
+        PagingConfig config;
+        ASSERT_TRUE(parseElementType("i64", config.element));
+        ASSERT_TRUE(sortTextFile(testInputFile, testOutputFile, testBinaryFile, algorithm, config));
+        std::ifstream in(testOutputFile);
+        std::string text;
+        std::getline(in, text);
+        ASSERT_EQ(text, "-9223372036854775808,-1,0,42,9223372036854775807") << algorithm;
+    }
+
+    out.open(testInputFile, std::ios::trunc);
+    out << "2.5,-1e300,0.1,3,-0.125";
+    out.close();
+    for (const char* algorithm : algorithms) {
+        PagingConfig config;
+        ASSERT_TRUE(parseElementType("f64", config.element));
+        ASSERT_TRUE(sortTextFile(testInputFile, testOutputFile, testBinaryFile, algorithm, config));
+        std::ifstream in(testOutputFile);
+        std::string text;
+        std::getline(in, text);
+        ASSERT_EQ(text, "-1.0000000000000001e+300,-0.125,0.10000000000000001,2.5,3") << algorithm;
+    }
+
+    std::remove(testInputFile.c_str());
+    std::remove(testOutputFile.c_str());
+}
+
+// Test de -t rec: registros de 12 bytes ordenados por una clave de 8 bytes en el byte 4,
+// con claves repetidas que tienen que conservar su orden
+TEST(PagedSortTest, RecordSortTest) {
+    std::string testBinaryFile = "test_records.bin";
+    const int n = 2000;
+    const int recordSize = 12;
+
+    std::vector<unsigned char> records(n * recordSize + 5);
+    for (int i = 0; i < n; i++) {
+        unsigned int position = i;
+        unsigned long long key = (static_cast<unsigned long long>(i) * 2654435761u) % 97;
+        key |= (i % 3 == 0) ? (1ull << 63) : 0;
+        std::memcpy(&records[i * recordSize], &position, sizeof(position));
+        std::memcpy(&records[i * recordSize + 4], &key, sizeof(key));
+    }
+    for (int i = 0; i < 5; i++) {
+        records[n * recordSize + i] = static_cast<unsigned char>(200 + i);
+    }
+
+    ElementType element;
+    ASSERT_FALSE(parseElementType("rec:8:4", element));
+    ASSERT_FALSE(parseElementType("rec:12:4:i16", element));
+    ASSERT_TRUE(parseElementType("rec:12:8:i32", element));
+    ASSERT_EQ(element.key, ElementType::I32);
+
+    // Con 3 marcos la copia final de los registros usa uno solo; con 5 y -r 1 QS deja un
+    // marco al arreglo y la copia no reserva marcos para leer por adelantado
+    const char* algorithms[] = { "QS", "MS", "RS", "QS", "QS" };
+    const int frames[] = { 6, 6, 6, 3, 5 };
+    const int readAhead[] = { 0, 0, 0, 0, 1 };
+    for (int a = 0; a < 5; a++) {
+        const char* algorithm = algorithms[a];
+        PagingConfig config;
+        ASSERT_TRUE(parseElementType("rec:12:4", config.element));
+        config.pageBytes = 128;
+        config.frames = frames[a];
+        config.readAhead = readAhead[a];
+        std::vector<unsigned char> sorted;
+        ASSERT_TRUE(sortThroughFile(testBinaryFile, records, algorithm, config, sorted));
+        ASSERT_EQ(sorted.size(), records.size());
+
+        for (int i = 1; i < n; i++) {
+            unsigned int previous, position;
+            unsigned long long previousKey, key;
+            std::memcpy(&previous, &sorted[(i - 1) * recordSize], sizeof(previous));
+            std::memcpy(&position, &sorted[i * recordSize], sizeof(position));
+            std::memcpy(&previousKey, &sorted[(i - 1) * recordSize + 4], sizeof(previousKey));
+            std::memcpy(&key, &sorted[i * recordSize + 4], sizeof(key));
+            ASSERT_TRUE(previousKey < key || (previousKey == key && previous < position))
+                << algorithm << " en el registro " << i;
+            // El resto del registro viaja con su clave
+            ASSERT_EQ(std::memcmp(&sorted[i * recordSize + 4],
+                                  &records[position * recordSize + 4], 8), 0);
+        }
+        ASSERT_EQ(std::memcmp(&sorted[n * recordSize], &records[n * recordSize], 5), 0)
+            << algorithm;
+    }
+    std::remove(testBinaryFile.c_str());
+}
+
+// Test de QS sobre una entrada ya ordenada: ninguna página cambia, así que ninguna se escribe
+TEST(PagedSortTest, QuickSortSortedCleanTest) {
+    std::string testBinaryFile = "test_sorted_clean.bin";
+
+    std::vector<int> numbers;
+    for (int i = 0; i < 100000; i++) {
+        numbers.push_back(i);
+    }
+
+    PagingStats stats;
+    PagingConfig config;
+    config.stats = &stats;
+    std::vector<int> sorted;
+    ASSERT_TRUE(sortThroughFile(testBinaryFile, numbers, "QS", config, sorted));
+
+    ASSERT_EQ(sorted, numbers);
+    ASSERT_EQ(stats.dirtyEvictions, 0);
+    ASSERT_EQ(stats.bytesWritten, 0);
+
+    std::remove(testBinaryFile.c_str());
+}
+
+// Test del seguimiento de páginas sucias: volver a escribir el mismo valor no ensucia la página,
+// y una escritura que sí cambia algo se guarda
+TEST(PagedSortTest, DirtyTrackingTest) {
+    std::string testBinaryFile = "test_dirty.bin";
+    const int n = 1000;
+
+    std::vector<int> numbers;
+    for (int i = 0; i < n; i++) {
+        numbers.push_back(i * 3 - 700);
+    }
+    {
+        std::ofstream out(testBinaryFile, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<char*>(numbers.data()), numbers.size() * sizeof(int));
+    }
+
+    PagingStats stats;
+    PagingConfig config;
+    config.pageBytes = 16 * sizeof(int);
+    config.frames = 3;
+    config.stats = &stats;
+    {
+        PagedArray<int> array(testBinaryFile, config);
+        for (long long i = 0; i < n; i++) {
+            array.write(i, array.read(i));
+            array[n - 1 - i] = array[n - 1 - i];
+            array.swap(i, i);
+        }
+    }
+    ASSERT_GT(stats.misses, config.frames);
+    ASSERT_EQ(stats.dirtyEvictions, 0);
+    ASSERT_EQ(stats.bytesWritten, 0);
+
+    stats = PagingStats();
+    {
+        PagedArray<int> array(testBinaryFile, config);
+        array[0] = 12345;
+    }
+    ASSERT_EQ(stats.bytesWritten, 16 * static_cast<long long>(sizeof(int)));
+
+    std::remove(testBinaryFile.c_str());
+}
+
+// Test del seguimiento de páginas sucias: ordenar una entrada que ya está en orden no escribe
+// ninguna página con ningún algoritmo que pase por PagedArray
+TEST(PagedSortTest, SortedInputCleanTest) {
+    std::string testBinaryFile = "test_sorted_input.bin";
+    const char* algorithms[] = { "QS", "IS", "SS", "PS" };
+
+    std::vector<int> numbers;
+    for (int i = 0; i < 2000; i++) {
+        numbers.push_back(i / 3);
+    }
+
+    for (const char* algorithm : algorithms) {
+        PagingStats stats;
+        PagingConfig config;
+        config.pageBytes = 32 * sizeof(int);
+        config.frames = 4;
+        config.stats = &stats;
+        std::vector<int> sorted;
+        ASSERT_TRUE(sortThroughFile(testBinaryFile, numbers, algorithm, config, sorted));
+
+        ASSERT_EQ(sorted, numbers) << algorithm;
+        ASSERT_EQ(stats.dirtyEvictions, 0) << algorithm;
+        ASSERT_EQ(stats.bytesWritten, 0) << algorithm;
+    }
+
+    std::remove(testBinaryFile.c_str());
+}
@@ -0,0 +1,380 @@
+#include "textio.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+
+// Pares de dígitos "00".."99" para escribir dos dígitos por división
+static const char DIGIT_PAIRS[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+
+// La lectura de 8 dígitos a la vez supone bytes en orden little endian
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define TEXTIO_SWAR 1
+#else
+#define TEXTIO_SWAR 0
+#endif
+
+#if TEXTIO_SWAR
+static const unsigned long long POWERS_OF_TEN[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull
+};
+
+
+static inline int leadingDigits(std::uint64_t& word) {
+    /**
+     * leadingDigits cuenta cuántos de los 8 bytes de word (en orden de memoria, little
+     * endian) son dígitos antes del primer carácter que no lo es, y deja en word los valores
+     * 0..9 de esos dígitos.
+     *
+     * @param uint64_t& word
+     * @return entre 0 y 8
+    */
+    word ^= 0x3030303030303030ull;
+    // Un byte es dígito si su nibble alto es 0 y el bajo no pasa de 9. El acarreo de la suma
+    // solo puede ensuciar bytes posteriores al primer no dígito, que no interesan.
+    std::uint64_t notDigit = (word & 0xF0F0F0F0F0F0F0F0ull) |
+                             ((word + 0x0606060606060606ull) & 0x1010101010101010ull);
+    if (notDigit == 0) {
+        return 8;
+    }
+#if defined(__GNUC__)
+    return __builtin_ctzll(notDigit) / 8;
+#else
+    int count = 0;
+    while ((notDigit & 0xFF) == 0) {
+        notDigit >>= 8;
+        count++;
+    }
+    return count;
+#endif
+}
+
+
+static inline unsigned long long swarValue(std::uint64_t word, int digits) {
+    /**
+     * swarValue convierte los primeros digits bytes de word (ya en 0..9) en su valor
+     * decimal con tres multiplicaciones en lugar de un ciclo por dígito.
+     *
+     * @param uint64_t word, int digits
+     * @return el valor de esos dígitos
+    */
+    // Correr los dígitos al final de la palabra: los bytes de adelante quedan en cero
+    word <<= 8 * (8 - digits);
+    word = (word * 10 + (word >> 8)) & 0x00FF00FF00FF00FFull;
+    word = (word * 100 + (word >> 16)) & 0x0000FFFF0000FFFFull;
+    word = (word * 10000 + (word >> 32)) & 0x00000000FFFFFFFFull;
+    return word;
+}
+#endif
+
+
+TextReader::TextReader(const std::string& filename, std::size_t chunkSize)
+    : in(filename, std::ios::binary), chunk(chunkSize) {}
+
+bool TextReader::isOpen() const {
+    return in.is_open();
+}
+
+bool TextReader::fill() {
+    // Trae el siguiente bloque cuando ya se consumió el actual; false al final del archivo
+    if (pos == len) {
+        in.read(chunk.data(), chunk.size());
+        len = static_cast<std::size_t>(in.gcount());
+        pos = 0;
+        if (len == 0) {
+            done = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Valor a partir del cual un dígito más puede pasarse de 64 bits
+static const unsigned long long DIGIT_LIMIT = std::numeric_limits<unsigned long long>::max() / 10;
+
+
+template <class T>
+static inline bool fitsIn(unsigned long long magnitude, bool negative) {
+    // Con signo, los negativos llegan a una unidad más que el máximo; sin signo, solo el -0
+    const unsigned long long limit = static_cast<unsigned long long>(std::numeric_limits<T>::max());
+    if (negative) {
+        return std::is_signed<T>::value ? magnitude <= limit + 1 : magnitude == 0;
+    }
+    return magnitude <= limit;
+}
+
+template <class T>
+std::size_t TextReader::readIntegers(T* numbers, std::size_t max) {
+    /**
+     * readIntegers interpreta hasta max enteros y los deja en numbers. El valor absoluto se
+     * acumula en 64 bits y al terminar cada número se revisa que quepa en T con su signo; si
+     * no cabe, se deja de leer sin guardarlo, como operator>>.
+     *
+     * @param T* numbers, size_t max
+     * @return la cantidad de enteros leídos; 0 cuando ya no quedan
+    */
+    std::size_t count = 0;
+
+    while (count < max && !done) {
+        if (!fill()) {
+            break;
+        }
+
+        // Copias locales del estado para que el ciclo trabaje en registros
+        const char* data = chunk.data();
+        std::size_t p = pos;
+        unsigned long long v = value;
+        bool minus = negative;
+        bool signSeen = sign;
+        bool started = inNumber;
+        bool afterComma = needNumber;
+        bool tooLarge = overflow;
+
+        while (p < len && count < max) {
+            unsigned char c = static_cast<unsigned char>(data[p]);
+            unsigned int digit = c - '0';
+            if (digit < 10) {
+#if TEXTIO_SWAR
+                // Camino rápido: de 8 en 8 dígitos mientras quepa una palabra en el bloque
+                // Mientras v sea menor que 10^11, ocho dígitos más no pasan de 64 bits
+                while (p + 8 <= len && v < 100000000000ull) {
+                    std::uint64_t word;
+                    std::memcpy(&word, data + p, sizeof(word));
+                    int digits = leadingDigits(word);
+                    if (digits == 0) {
+                        break;
+                    }
+                    v = v * POWERS_OF_TEN[digits] + swarValue(word, digits);
+                    p += digits;
+                    if (digits < 8) {
+                        break;
+                    }
+                }
+#endif
+                // Dígito por dígito cerca del final del bloque
+                while (p < len && (digit = static_cast<unsigned char>(data[p]) - '0') < 10) {
+                    if (v >= DIGIT_LIMIT && (v > DIGIT_LIMIT || digit > 5)) {
+                        tooLarge = true;
+                    }
+                    v = v * 10 + digit;
+                    p++;
+                }
+                started = true;
+                continue;
+            }
+
+            p++;
+            if (c == ',' || c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+                if (started) {
+                    if (tooLarge || !fitsIn<T>(v, minus)) {
+                        done = true;
+                        break;
+                    }
+                    numbers[count++] = static_cast<T>(minus ? 0 - v : v);
+                    afterComma = c == ',';
+                } else if (signSeen || (c == ',' && afterComma)) {
+                    // Un signo sin dígitos o un campo vacío: operator>> no lee ningún número
+                    done = true;
+                    break;
+                } else if (c == ',') {
+                    afterComma = true;
+                }
+                v = 0;
+                minus = false;
+                signSeen = false;
+                started = false;
+            } else if ((c == '-' || c == '+') && !started && !signSeen) {
+                minus = c == '-';
+                signSeen = true;
+            } else {
+                done = true;
+                break;
+            }
+        }
+
+        pos = p;
+        value = v;
+        negative = minus;
+        sign = signSeen;
+        inNumber = started;
+        needNumber = afterComma;
+        overflow = tooLarge;
+    }
+
+    // El último número del archivo no lleva coma después
+    if (done && inNumber && count < max) {
+        if (!overflow && fitsIn<T>(value, negative)) {
+            numbers[count++] = static_cast<T>(negative ? 0 - value : value);
+        }
+        inNumber = false;
+    }
+    return count;
+}
+
+std::size_t TextReader::read(int* numbers, std::size_t max) {
+    return readIntegers(numbers, max);
+}
+
+std::size_t TextReader::read(long long* numbers, std::size_t max) {
+    return readIntegers(numbers, max);
+}
+
+std::size_t TextReader::read(unsigned long long* numbers, std::size_t max) {
+    return readIntegers(numbers, max);
+}
+
+bool TextReader::parseToken(double& number) {
+    // Interpreta token con strtod; si sobran caracteres, el número vale pero se deja de leer
+    const char* start = token.c_str();
+    char* end;
+    number = std::strtod(start, &end);
+    if (end != start + token.size()) {
+        done = true;
+    }
+    token.clear();
+    return end != start;
+}
+
+std::size_t TextReader::read(double* numbers, std::size_t max) {
+    /**
+     * read con double junta los caracteres de cada número hasta el separador y los
+     * interpreta con strtod, así acepta decimales, exponentes, inf y nan.
+     *
+     * @param double* numbers, size_t max
+     * @return la cantidad de números leídos; 0 cuando ya no quedan
+    */
+    std::size_t count = 0;
+
+    while (count < max && !done) {
+        if (!fill()) {
+            break;
+        }
+        while (pos < len && count < max && !done) {
+            char c = chunk[pos++];
+            if (c == ',' || c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+                if (!token.empty()) {
+                    if (parseToken(numbers[count])) {
+                        count++;
+                    }
+                    needNumber = c == ',';
+                } else if (c == ',' && needNumber) {
+                    done = true;  // Campo vacío: operator>> no lee ningún número
+                } else if (c == ',') {
+                    needNumber = true;
+                }
+            } else {
+                token.push_back(c);
+            }
+        }
+    }
+
+    // El último número del archivo no lleva coma después
+    if (done && !token.empty() && count < max && parseToken(numbers[count])) {
+        count++;
+    }
+    return count;
+}
+
+
+TextWriter::TextWriter(const std::string& filename)
+    : out(filename, std::ios::binary | std::ios::trunc), buffer(TEXT_CHUNK) {}
+
+TextWriter::~TextWriter() {
+    flush();
+}
+
+void TextWriter::flush() {
+    out.write(buffer.data(), used);
+    used = 0;
+}
+
+template <class T>
+static inline bool isNegative(T value) {
+    return value < 0;
+}
+
+static inline bool isNegative(unsigned long long) {
+    return false;
+}
+
+template <class T>
+void TextWriter::writeIntegers(const T* numbers, std::size_t count) {
+    typedef typename std::make_unsigned<T>::type Unsigned;
+    // Una coma, un signo y veinte dígitos como máximo por número
+    const std::size_t longest = 22;
+
+    for (std::size_t i = 0; i < count; i++) {
+        if (used + longest > buffer.size()) {
+            flush();
+        }
+        char* p = buffer.data() + used;
+        if (!first) {
+            *p++ = ',';
+        }
+        first = false;
+
+        Unsigned v = static_cast<Unsigned>(numbers[i]);
+        if (isNegative(numbers[i])) {
+            *p++ = '-';
+            v = 0u - v;
+        }
+
+        // Escribir los dígitos de atrás hacia adelante en un temporal
+        char digits[20];
+        char* end = digits + sizeof(digits);
+        char* d = end;
+        while (v >= 100) {
+            unsigned int pair = static_cast<unsigned int>(v % 100) * 2;
+            v /= 100;
+            *--d = DIGIT_PAIRS[pair + 1];
+            *--d = DIGIT_PAIRS[pair];
+        }
+        if (v >= 10) {
+            *--d = DIGIT_PAIRS[v * 2 + 1];
+            *--d = DIGIT_PAIRS[v * 2];
+        } else {
+            *--d = static_cast<char>('0' + v);
+        }
+        std::memcpy(p, d, end - d);
+        p += end - d;
+
+        used = p - buffer.data();
+    }
+}
+
+void TextWriter::write(const int* numbers, std::size_t count) {
+    writeIntegers(numbers, count);
+}
+
+void TextWriter::write(const long long* numbers, std::size_t count) {
+    writeIntegers(numbers, count);
+}
+
+void TextWriter::write(const unsigned long long* numbers, std::size_t count) {
+    writeIntegers(numbers, count);
+}
+
+void TextWriter::write(const double* numbers, std::size_t count) {
+    // Una coma y "%.17g": signo, 17 dígitos, punto y exponente de hasta tres dígitos
+    const std::size_t longest = 32;
+
+    for (std::size_t i = 0; i < count; i++) {
+        if (used + longest > buffer.size()) {
+            flush();
+        }
+        char* p = buffer.data() + used;
+        if (!first) {
+            *p++ = ',';
+        }
+        first = false;
+        p += std::snprintf(p, longest - 1, "%.17g", numbers[i]);
+        used = p - buffer.data();
+    }
+}
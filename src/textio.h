@@ -0,0 +1,74 @@
+#ifndef TEXTIO_H
+#define TEXTIO_H
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+const std::size_t TEXT_CHUNK = 1 << 20;  // bytes que se leen o escriben de una sola vez
+
+
+class TextReader {
+    /*TextReader lee los números separados por comas de un archivo de texto en bloques de
+     * TEXT_CHUNK bytes. Los enteros se interpretan a mano, sin pasar por operator>>; los
+     * double se juntan carácter por carácter y se interpretan con strtod. El estado del
+     * número que se está leyendo se conserva entre bloques, así que un número puede quedar
+     * partido entre dos lecturas. Acepta signo, espacios y saltos de línea entre números; al
+     * primer carácter que no reconoce, al primer campo vacío o signo sin dígitos, o al primer
+     * entero que no cabe en el tipo pedido deja de leer, igual que operator>>.
+    */
+    std::ifstream in;
+    std::vector<char> chunk;
+    std::size_t pos = 0;
+    std::size_t len = 0;
+
+    unsigned long long value = 0;
+    bool negative = false;
+    bool sign = false;  // se leyó el signo del número y todavía ningún dígito
+    bool inNumber = false;
+    bool needNumber = true;  // al principio y después de una coma tiene que venir un número
+    bool overflow = false;  // el entero que se está leyendo ya no cabe en 64 bits
+    std::string token;  // caracteres del double que se está leyendo
+    bool done = false;
+
+    bool fill();
+    template <class T>
+    std::size_t readIntegers(T* numbers, std::size_t max);
+    bool parseToken(double& number);
+
+public:
+    explicit TextReader(const std::string& filename, std::size_t chunkSize = TEXT_CHUNK);
+    bool isOpen() const;
+    std::size_t read(int* numbers, std::size_t max);
+    std::size_t read(long long* numbers, std::size_t max);
+    std::size_t read(unsigned long long* numbers, std::size_t max);
+    std::size_t read(double* numbers, std::size_t max);
+};
+
+
+class TextWriter {
+    /*TextWriter escribe números separados por comas dentro de un búfer de TEXT_CHUNK bytes
+     * que se vacía de una sola vez. Los enteros se formatean a mano; los double con los 17
+     * dígitos significativos que hacen falta para volver a leer el mismo valor.
+    */
+    std::ofstream out;
+    std::vector<char> buffer;
+    std::size_t used = 0;
+    bool first = true;
+
+    void flush();
+    template <class T>
+    void writeIntegers(const T* numbers, std::size_t count);
+
+public:
+    explicit TextWriter(const std::string& filename);
+    ~TextWriter();
+    void write(const int* numbers, std::size_t count);
+    void write(const long long* numbers, std::size_t count);
+    void write(const unsigned long long* numbers, std::size_t count);
+    void write(const double* numbers, std::size_t count);
+};
+
+#endif